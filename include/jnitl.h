@@ -1,14 +1,46 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
+#include <set>
 #include <span>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #include <jni.h>
 
+#if !defined(JNITL_DYNAMIC_JVM)
+#if defined(__ANDROID__) || defined(_WIN32)
+#define JNITL_DYNAMIC_JVM 0
+#else
+#define JNITL_DYNAMIC_JVM 1
+#endif
+#endif
+
+#if JNITL_DYNAMIC_JVM
+#include <dlfcn.h>
+#endif
+
 template <typename A, typename B>
 constexpr bool java_is_same = false;
 
@@ -95,17 +127,27 @@ struct java_value_t {
     std::swap(env_, that.env_);
   }
 
+  JNIEnv *
+  env() const {
+    return env_;
+  }
+
 protected:
   JNIEnv *env_;
 };
 
+template <typename T>
+concept java_reference_type = std::is_base_of_v<java_value_t, T>;
+
 template <size_t N>
 using java_class_name_t = java_string_literal_t<N>;
 
 template <java_class_name_t, typename>
 struct java_field_t;
 
-template <java_class_name_t, typename>
+struct java_unchecked_t;
+
+template <java_class_name_t, typename, typename = java_unchecked_t>
 struct java_method_t;
 
 template <java_class_name_t, typename>
@@ -153,13 +195,13 @@ struct java_object_t : java_value_t {
   void
   set(const java_field_t<N, T> &field, T value) const;
 
-  template <typename... A>
-  void
-  apply(const java_method_t<N, void(A...)> &method, A... args) const;
+  template <typename P, typename... A>
+  auto
+  apply(const java_method_t<N, void(A...), P> &method, A... args) const;
 
-  template <typename R, typename... A>
-  R
-  apply(const java_method_t<N, R(A...)> &method, A... args) const;
+  template <typename R, typename P, typename... A>
+  auto
+  apply(const java_method_t<N, R(A...), P> &method, A... args) const;
 
   template <typename T = java_object_t<N>>
   auto
@@ -183,6 +225,9 @@ private:
   template <typename>
   friend struct java_weak_local_ref_t;
 
+  template <typename>
+  friend struct java_shared_ref_t;
+
 protected:
   jobject handle_;
 };
@@ -265,6 +310,339 @@ struct java_weak_global_ref_t : T {
   }
 };
 
+template <typename F>
+static inline void
+java_with_env(JavaVM *vm, F fn) {
+  JNIEnv *env;
+
+  if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) == JNI_OK) return fn(env);
+
+#if defined(__ANDROID__)
+  if (vm->AttachCurrentThread(&env, nullptr) != JNI_OK) return;
+#else
+  if (vm->AttachCurrentThread(reinterpret_cast<void **>(&env), nullptr) != JNI_OK) return;
+#endif
+
+  fn(env);
+
+  vm->DetachCurrentThread();
+}
+
+template <typename T>
+struct java_shared_ref_t {
+  java_shared_ref_t() : control_(nullptr) {}
+
+  java_shared_ref_t(JNIEnv *env, jobject handle) : control_(nullptr) {
+    if (handle) control_ = new control_t(env, env->NewGlobalRef(handle));
+  }
+
+  java_shared_ref_t(const T &object) : java_shared_ref_t(object.env_, object.handle_) {}
+
+  java_shared_ref_t(java_shared_ref_t &&that) : java_shared_ref_t() {
+    swap(that);
+  }
+
+  java_shared_ref_t(const java_shared_ref_t &that) : control_(that.control_) {
+    if (control_) control_->refs_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ~java_shared_ref_t() {
+    if (control_ && control_->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) delete control_;
+  }
+
+  java_shared_ref_t &
+  operator=(java_shared_ref_t that) {
+    swap(that);
+
+    return *this;
+  }
+
+  operator jobject() const {
+    return control_ ? control_->handle_ : nullptr;
+  }
+
+  explicit operator bool() const {
+    return control_ != nullptr;
+  }
+
+  void
+  swap(java_shared_ref_t &that) {
+    std::swap(control_, that.control_);
+  }
+
+  T
+  get(JNIEnv *env) const {
+    return T(env, *this);
+  }
+
+  size_t
+  use_count() const {
+    return control_ ? control_->refs_.load(std::memory_order_relaxed) : 0;
+  }
+
+private:
+  struct control_t {
+    control_t(JNIEnv *env, jobject handle) : refs_(1), vm_(nullptr), handle_(handle) {
+      env->GetJavaVM(&vm_);
+    }
+
+    ~control_t() {
+      java_with_env(vm_, [this](JNIEnv *env) {
+        env->DeleteGlobalRef(handle_);
+      });
+    }
+
+    std::atomic<size_t> refs_;
+    JavaVM *vm_;
+    jobject handle_;
+  };
+
+  control_t *control_;
+};
+
+struct java_identity_info_t {
+  jclass system_;
+  jmethodID identity_hash_code_;
+
+  static const java_identity_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_identity_info_t info;
+
+      auto system = env->FindClass("java/lang/System");
+
+      info.system_ = reinterpret_cast<jclass>(env->NewGlobalRef(system));
+      info.identity_hash_code_ = env->GetStaticMethodID(system, "identityHashCode", "(Ljava/lang/Object;)I");
+
+      env->DeleteLocalRef(system);
+
+      return info;
+    }(env);
+
+    return info;
+  }
+
+  jint
+  hash(JNIEnv *env, jobject object) const {
+    return env->CallStaticIntMethod(system_, identity_hash_code_, object);
+  }
+};
+
+template <typename V, size_t S = 16>
+struct java_identity_map_t {
+  static_assert(std::has_single_bit(S));
+
+  java_identity_map_t(JNIEnv *env) : vm_(nullptr), info_(java_identity_info_t::get(env)) {
+    env->GetJavaVM(&vm_);
+  }
+
+  java_identity_map_t(const java_identity_map_t &) = delete;
+
+  ~java_identity_map_t() {
+    java_with_env(vm_, [this](JNIEnv *env) {
+      clear(env);
+    });
+  }
+
+  java_identity_map_t &
+  operator=(const java_identity_map_t &) = delete;
+
+  std::optional<V>
+  find(JNIEnv *env, jobject key) const {
+    auto hash = info_.hash(env, key);
+
+    auto &shard = shards_[index(hash)];
+
+    std::lock_guard lock(shard.mutex_);
+
+    auto bucket = shard.buckets_.find(hash);
+
+    if (bucket == shard.buckets_.end()) return std::nullopt;
+
+    for (auto &entry : bucket->second) {
+      if (env->IsSameObject(entry.ref_, key)) return entry.value_;
+    }
+
+    return std::nullopt;
+  }
+
+  bool
+  contains(JNIEnv *env, jobject key) const {
+    return find(env, key) != std::nullopt;
+  }
+
+  bool
+  insert(JNIEnv *env, jobject key, V value) {
+    auto hash = info_.hash(env, key);
+
+    auto &shard = shards_[index(hash)];
+
+    std::lock_guard lock(shard.mutex_);
+
+    auto &bucket = shard.buckets_[hash];
+
+    sweep(env, shard, bucket);
+
+    for (auto &entry : bucket) {
+      if (env->IsSameObject(entry.ref_, key)) {
+        entry.value_ = std::move(value);
+
+        return false;
+      }
+    }
+
+    bucket.push_back({env->NewWeakGlobalRef(key), std::move(value)});
+
+    shard.size_++;
+
+    return true;
+  }
+
+  template <typename F>
+  V
+  get_or_insert(JNIEnv *env, jobject key, F fn) {
+    auto hash = info_.hash(env, key);
+
+    auto &shard = shards_[index(hash)];
+
+    std::lock_guard lock(shard.mutex_);
+
+    auto &bucket = shard.buckets_[hash];
+
+    sweep(env, shard, bucket);
+
+    for (auto &entry : bucket) {
+      if (env->IsSameObject(entry.ref_, key)) return entry.value_;
+    }
+
+    auto &entry = bucket.emplace_back(env->NewWeakGlobalRef(key), fn());
+
+    shard.size_++;
+
+    return entry.value_;
+  }
+
+  bool
+  erase(JNIEnv *env, jobject key) {
+    auto hash = info_.hash(env, key);
+
+    auto &shard = shards_[index(hash)];
+
+    std::lock_guard lock(shard.mutex_);
+
+    auto bucket = shard.buckets_.find(hash);
+
+    if (bucket == shard.buckets_.end()) return false;
+
+    auto &entries = bucket->second;
+
+    for (auto it = entries.begin(); it != entries.end(); it++) {
+      if (env->IsSameObject(it->ref_, key)) {
+        env->DeleteWeakGlobalRef(it->ref_);
+
+        entries.erase(it);
+
+        shard.size_--;
+
+        if (entries.empty()) shard.buckets_.erase(bucket);
+
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  size_t
+  sweep(JNIEnv *env) {
+    size_t swept = 0;
+
+    for (auto &shard : shards_) {
+      std::lock_guard lock(shard.mutex_);
+
+      for (auto it = shard.buckets_.begin(); it != shard.buckets_.end();) {
+        swept += sweep(env, shard, it->second);
+
+        if (it->second.empty()) it = shard.buckets_.erase(it);
+        else it++;
+      }
+    }
+
+    return swept;
+  }
+
+  void
+  clear(JNIEnv *env) {
+    for (auto &shard : shards_) {
+      std::lock_guard lock(shard.mutex_);
+
+      for (auto &[hash, entries] : shard.buckets_) {
+        for (auto &entry : entries) env->DeleteWeakGlobalRef(entry.ref_);
+      }
+
+      shard.buckets_.clear();
+      shard.size_ = 0;
+    }
+  }
+
+  size_t
+  size() const {
+    size_t size = 0;
+
+    for (auto &shard : shards_) {
+      std::lock_guard lock(shard.mutex_);
+
+      size += shard.size_;
+    }
+
+    return size;
+  }
+
+private:
+  struct entry_t {
+    entry_t(jweak ref, V value) : ref_(ref), value_(std::move(value)) {}
+
+    jweak ref_;
+    V value_;
+  };
+
+  struct shard_t {
+    mutable std::mutex mutex_;
+    std::unordered_map<jint, std::vector<entry_t>> buckets_;
+    size_t size_ = 0;
+  };
+
+  static size_t
+  index(jint hash) {
+    auto bits = static_cast<uint32_t>(hash);
+
+    return (bits ^ (bits >> 16)) & (S - 1);
+  }
+
+  static size_t
+  sweep(JNIEnv *env, shard_t &shard, std::vector<entry_t> &entries) {
+    auto n = entries.size();
+
+    std::erase_if(entries, [env](const entry_t &entry) {
+      if (!env->IsSameObject(entry.ref_, nullptr)) return false;
+
+      env->DeleteWeakGlobalRef(entry.ref_);
+
+      return true;
+    });
+
+    auto swept = n - entries.size();
+
+    shard.size_ -= swept;
+
+    return swept;
+  }
+
+  JavaVM *vm_;
+  const java_identity_info_t &info_;
+  std::array<shard_t, S> shards_;
+};
+
 struct java_string_t : java_object_t<"java/lang/String"> {
   java_string_t() : java_object_t(), utf8_(nullptr) {}
 
@@ -878,22 +1256,181 @@ struct java_array_t : java_object_t<"java/lang/Object"> {
   }
 };
 
+template <size_t N>
+struct java_unsigned_integer;
+
+template <>
+struct java_unsigned_integer<2> {
+  using type = uint16_t;
+};
+
+template <>
+struct java_unsigned_integer<4> {
+  using type = uint32_t;
+};
+
+template <>
+struct java_unsigned_integer<8> {
+  using type = uint64_t;
+};
+
+template <typename T>
+static inline T
+java_byteswap(T value) {
+  using U = typename java_unsigned_integer<sizeof(T)>::type;
+
+  auto bits = std::bit_cast<U>(value);
+
+#if defined(_MSC_VER)
+  if constexpr (sizeof(T) == 2) bits = _byteswap_ushort(bits);
+  else if constexpr (sizeof(T) == 4) bits = _byteswap_ulong(bits);
+  else bits = _byteswap_uint64(bits);
+#else
+  if constexpr (sizeof(T) == 2) bits = __builtin_bswap16(bits);
+  else if constexpr (sizeof(T) == 4) bits = __builtin_bswap32(bits);
+  else bits = __builtin_bswap64(bits);
+#endif
+
+  return std::bit_cast<T>(bits);
+}
+
+template <typename T>
+static inline void
+java_decode_values(std::span<const uint8_t> src, std::span<T> dest, std::endian order) {
+  static_assert(std::is_arithmetic_v<T>);
+
+  if (src.size() < dest.size_bytes()) throw std::out_of_range("Source is too small");
+
+  if constexpr (sizeof(T) == 1) {
+    std::memcpy(dest.data(), src.data(), dest.size_bytes());
+  } else if (order == std::endian::native) {
+    std::memcpy(dest.data(), src.data(), dest.size_bytes());
+  } else {
+    for (size_t i = 0, n = dest.size(); i < n; i++) {
+      T value;
+      std::memcpy(&value, src.data() + i * sizeof(T), sizeof(T));
+      dest[i] = java_byteswap(value);
+    }
+  }
+}
+
+template <typename T>
+static inline void
+java_encode_values(std::span<const T> src, std::span<uint8_t> dest, std::endian order) {
+  static_assert(std::is_arithmetic_v<T>);
+
+  if (dest.size() < src.size_bytes()) throw std::out_of_range("Destination is too small");
+
+  if constexpr (sizeof(T) == 1) {
+    std::memcpy(dest.data(), src.data(), src.size_bytes());
+  } else if (order == std::endian::native) {
+    std::memcpy(dest.data(), src.data(), src.size_bytes());
+  } else {
+    for (size_t i = 0, n = src.size(); i < n; i++) {
+      auto value = java_byteswap(src[i]);
+      std::memcpy(dest.data() + i * sizeof(T), &value, sizeof(T));
+    }
+  }
+}
+
+struct java_byte_buffer_info_t {
+  jmethodID order_;
+  jmethodID has_array_;
+  jmethodID array_;
+  jmethodID array_offset_;
+  jmethodID position_;
+  jmethodID limit_;
+  jobject big_endian_;
+
+  static const java_byte_buffer_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_byte_buffer_info_t info;
+
+      auto byte_buffer = env->FindClass("java/nio/ByteBuffer");
+
+      info.order_ = env->GetMethodID(byte_buffer, "order", "()Ljava/nio/ByteOrder;");
+      info.has_array_ = env->GetMethodID(byte_buffer, "hasArray", "()Z");
+      info.array_ = env->GetMethodID(byte_buffer, "array", "()[B");
+      info.array_offset_ = env->GetMethodID(byte_buffer, "arrayOffset", "()I");
+      info.position_ = env->GetMethodID(byte_buffer, "position", "()I");
+      info.limit_ = env->GetMethodID(byte_buffer, "limit", "()I");
+
+      auto byte_order = env->FindClass("java/nio/ByteOrder");
+
+      auto big_endian = env->GetStaticObjectField(byte_order, env->GetStaticFieldID(byte_order, "BIG_ENDIAN", "Ljava/nio/ByteOrder;"));
+
+      info.big_endian_ = env->NewGlobalRef(big_endian);
+
+      env->DeleteLocalRef(big_endian);
+      env->DeleteLocalRef(byte_order);
+      env->DeleteLocalRef(byte_buffer);
+
+      return info;
+    }(env);
+
+    return info;
+  }
+
+  std::endian
+  order(JNIEnv *env, jobject buffer) const {
+    auto order = env->CallObjectMethod(buffer, order_);
+
+    auto result = env->IsSameObject(order, big_endian_) ? std::endian::big : std::endian::little;
+
+    env->DeleteLocalRef(order);
+
+    return result;
+  }
+};
+
 struct java_byte_buffer_t : java_object_t<"java/nio/ByteBuffer"> {
-  java_byte_buffer_t() : java_object_t(), data_(nullptr), size_(0) {}
+  java_byte_buffer_t() : java_object_t(), data_(nullptr), array_(nullptr), offset_(0), size_(0), order_(std::nullopt) {}
 
   java_byte_buffer_t(JNIEnv *env, jobject handle)
       : java_object_t(env, handle),
-        data_(env->GetDirectBufferAddress(handle)),
-        size_(env->GetDirectBufferCapacity(handle)) {}
+        data_(nullptr),
+        array_(nullptr),
+        offset_(0),
+        size_(0),
+        order_(std::nullopt) {
+    if (handle == nullptr) return;
+
+    data_ = reinterpret_cast<uint8_t *>(env->GetDirectBufferAddress(handle));
+
+    if (data_) {
+      size_ = env->GetDirectBufferCapacity(handle);
+
+      return;
+    }
+
+    auto &info = java_byte_buffer_info_t::get(env);
+
+    if (!env->CallBooleanMethod(handle, info.has_array_)) {
+      throw std::invalid_argument("Byte buffer is neither direct nor backed by an accessible array");
+    }
+
+    auto position = env->CallIntMethod(handle, info.position_);
+
+    array_ = reinterpret_cast<jbyteArray>(env->CallObjectMethod(handle, info.array_));
+    offset_ = env->CallIntMethod(handle, info.array_offset_) + position;
+    size_ = env->CallIntMethod(handle, info.limit_) - position;
+  }
 
   java_byte_buffer_t(JNIEnv *env, uint8_t *data, size_t len)
       : java_byte_buffer_t(env, env->NewDirectByteBuffer(data, len)) {}
 
-  java_byte_buffer_t(java_byte_buffer_t &&that) {
+  java_byte_buffer_t(java_byte_buffer_t &&that) : java_byte_buffer_t() {
     swap(that);
   }
 
-  java_byte_buffer_t(const java_byte_buffer_t &that) : java_object_t(that), data_(that.data_), size_(that.size_) {}
+  java_byte_buffer_t(const java_byte_buffer_t &that)
+      : java_object_t(that),
+        data_(that.data_),
+        array_(that.array_),
+        offset_(that.offset_),
+        size_(that.size_),
+        order_(that.order_) {}
 
   java_byte_buffer_t &
   operator=(java_byte_buffer_t that) {
@@ -908,12 +1445,16 @@ struct java_byte_buffer_t : java_object_t<"java/nio/ByteBuffer"> {
 
   uint8_t &
   operator[](size_t i) {
-    return reinterpret_cast<uint8_t *>(data_)[i];
+    if (data_ == nullptr) throw std::logic_error("Byte buffer has no direct address");
+
+    return data_[i];
   }
 
   const uint8_t
   operator[](size_t i) const {
-    return reinterpret_cast<uint8_t *>(data_)[i];
+    if (data_ == nullptr) throw std::logic_error("Byte buffer has no direct address");
+
+    return data_[i];
   }
 
   void
@@ -921,54 +1462,315 @@ struct java_byte_buffer_t : java_object_t<"java/nio/ByteBuffer"> {
     java_object_t::swap(that);
 
     std::swap(data_, that.data_);
+    std::swap(array_, that.array_);
+    std::swap(offset_, that.offset_);
     std::swap(size_, that.size_);
+    std::swap(order_, that.order_);
   }
 
   auto
   data() const {
-    return reinterpret_cast<uint8_t *>(data_);
+    return data_;
   }
 
   auto
-  size() const {
-    return size_;
+  is_direct() const {
+    return data_ != nullptr;
   }
 
-  auto
-  empty() const {
-    return size_ == 0;
-  }
+  std::endian
+  order() const {
+    if (order_ == std::nullopt) order_ = java_byte_buffer_info_t::get(env_).order(env_, handle_);
 
-  auto
-  begin() const {
-    return reinterpret_cast<uint8_t *>(data_);
+    return *order_;
   }
 
+  template <typename F>
   auto
-  end() const {
-    return reinterpret_cast<uint8_t *>(data_) + size_;
-  }
+  critical(F fn, int mode = 0) const {
+    if (data_ || array_ == nullptr) return fn(std::span(data_, size_));
 
-private:
-  void *data_;
-  size_t size_;
-};
-
-template <typename T>
-struct java_type_info_t;
+    auto elements = reinterpret_cast<uint8_t *>(env_->GetPrimitiveArrayCritical(array_, nullptr));
 
-template <>
-struct java_type_info_t<void> {
-  using type = void;
+    if (elements == nullptr) throw std::bad_alloc();
 
-  static constexpr java_string_literal_t signature = "V";
-};
+    struct release_t {
+      JNIEnv *env;
+      jbyteArray array;
+      uint8_t *elements;
+      int mode;
 
-template <>
-struct java_type_info_t<bool> {
-  using type = jboolean;
+      ~release_t() {
+        env->ReleasePrimitiveArrayCritical(array, elements, mode);
+      }
+    } release{env_, array_, elements, mode};
 
-  static constexpr java_string_literal_t signature = "Z";
+    return fn(std::span(elements + offset_, size_));
+  }
+
+  template <typename T, size_t E>
+  void
+  copy_to(std::span<T, E> dest, size_t start = 0) const {
+    copy_to(dest, start, order());
+  }
+
+  template <typename T, size_t E>
+  void
+  copy_to(std::span<T, E> dest, size_t start, std::endian order) const {
+    if (start > size_) throw std::out_of_range("Start is out of bounds");
+
+    if constexpr (sizeof(T) == 1) {
+      if (data_ == nullptr) {
+        if (dest.size() > size_ - start) throw std::out_of_range("Source is too small");
+
+        env_->GetByteArrayRegion(array_, offset_ + start, dest.size(), reinterpret_cast<jbyte *>(dest.data()));
+
+        return;
+      }
+    }
+
+    critical([&](std::span<uint8_t> data) {
+      java_decode_values<T>(data.subspan(start), std::span<T>(dest), order);
+    }, JNI_ABORT);
+  }
+
+  template <typename T, size_t E>
+  void
+  copy_from(std::span<T, E> src, size_t start = 0) {
+    copy_from(src, start, order());
+  }
+
+  template <typename T, size_t E>
+  void
+  copy_from(std::span<T, E> src, size_t start, std::endian order) {
+    if (start > size_) throw std::out_of_range("Start is out of bounds");
+
+    if constexpr (sizeof(T) == 1) {
+      if (data_ == nullptr) {
+        if (src.size() > size_ - start) throw std::out_of_range("Destination is too small");
+
+        env_->SetByteArrayRegion(array_, offset_ + start, src.size(), reinterpret_cast<const jbyte *>(src.data()));
+
+        return;
+      }
+    }
+
+    critical([&](std::span<uint8_t> data) {
+      java_encode_values<std::remove_const_t<T>>(std::span<const T>(src), data.subspan(start), order);
+    });
+  }
+
+  template <typename T = uint8_t>
+  auto
+  slice(size_t start, size_t count) const {
+    std::vector<T> result(count);
+
+    copy_to(std::span(result), start);
+
+    return result;
+  }
+
+  auto
+  size() const {
+    return size_;
+  }
+
+  auto
+  empty() const {
+    return size_ == 0;
+  }
+
+  auto
+  begin() const {
+    return data_;
+  }
+
+  auto
+  end() const {
+    return data_ ? data_ + size_ : data_;
+  }
+
+private:
+  uint8_t *data_;
+  jbyteArray array_;
+  size_t offset_;
+  size_t size_;
+  mutable std::optional<std::endian> order_;
+};
+
+struct java_ring_buffer_t {
+  static constexpr size_t cache_line = 64;
+
+  static constexpr size_t tail_offset = 0;
+  static constexpr size_t head_offset = 2 * cache_line;
+  static constexpr size_t header_size = 4 * cache_line;
+
+  static constexpr size_t record_header_size = 8;
+  static constexpr size_t record_alignment = 8;
+
+  static constexpr int32_t padding_type = -1;
+
+  java_ring_buffer_t() : data_(nullptr), capacity_(0) {}
+
+  java_ring_buffer_t(const java_byte_buffer_t &buffer) : data_(buffer.data()), capacity_(buffer.size() - header_size) {
+    if (data_ == nullptr || buffer.size() < header_size) {
+      throw std::invalid_argument("Ring buffer requires a direct byte buffer");
+    }
+
+    if (!std::has_single_bit(capacity_) || capacity_ < record_alignment) {
+      throw std::invalid_argument("Ring buffer capacity must be a power of two");
+    }
+
+    if (reinterpret_cast<uintptr_t>(data_) % record_alignment != 0) {
+      throw std::invalid_argument("Ring buffer must be aligned to " + std::to_string(record_alignment) + " bytes");
+    }
+  }
+
+  static constexpr size_t
+  length(size_t capacity) {
+    return header_size + capacity;
+  }
+
+  auto
+  capacity() const {
+    return capacity_;
+  }
+
+  auto
+  max_length() const {
+    return capacity_ / 8 - record_header_size;
+  }
+
+  bool
+  write(int32_t type, std::span<const uint8_t> data) {
+    if (type < 0) throw std::invalid_argument("Record type must be non-negative");
+
+    if (data.size() > max_length()) throw std::invalid_argument("Record exceeds maximum length");
+
+    auto length = record_header_size + data.size();
+    auto required = align(length);
+
+    auto tail = position(tail_offset).load(std::memory_order_acquire);
+    auto head = position(head_offset).load(std::memory_order_acquire);
+
+    size_t index, padding;
+
+    do {
+      if (required > capacity_ - (tail - head)) {
+        head = position(head_offset).load(std::memory_order_acquire);
+
+        if (required > capacity_ - (tail - head)) return false;
+      }
+
+      index = tail & (capacity_ - 1);
+      padding = 0;
+
+      if (required > capacity_ - index) {
+        padding = capacity_ - index;
+
+        if (required + padding > capacity_ - (tail - head)) return false;
+      }
+    } while (!position(tail_offset).compare_exchange_weak(tail, tail + padding + required, std::memory_order_acq_rel));
+
+    if (padding) {
+      record_type(index) = padding_type;
+      record_length(index).store(padding, std::memory_order_release);
+
+      index = 0;
+    }
+
+    record_type(index) = type;
+
+    std::copy(data.begin(), data.end(), records() + index + record_header_size);
+
+    record_length(index).store(length, std::memory_order_release);
+
+    return true;
+  }
+
+  bool
+  write(int32_t type, const void *data, size_t len) {
+    return write(type, std::span(reinterpret_cast<const uint8_t *>(data), len));
+  }
+
+  template <typename F>
+  size_t
+  read(F fn, size_t limit = -1) {
+    auto head = position(head_offset).load(std::memory_order_relaxed);
+
+    size_t read = 0, consumed = 0;
+
+    while (read < limit && consumed < capacity_) {
+      auto index = (head + consumed) & (capacity_ - 1);
+
+      auto length = record_length(index).load(std::memory_order_acquire);
+
+      if (length == 0) break;
+
+      auto type = record_type(index);
+      auto required = align(length);
+
+      if (type != padding_type) {
+        fn(type, std::span<const uint8_t>(records() + index + record_header_size, length - record_header_size));
+
+        read++;
+      }
+
+      std::fill_n(records() + index, required, 0);
+
+      consumed += required;
+    }
+
+    if (consumed) position(head_offset).store(head + consumed, std::memory_order_release);
+
+    return read;
+  }
+
+private:
+  static constexpr size_t
+  align(size_t length) {
+    return (length + record_alignment - 1) & ~(record_alignment - 1);
+  }
+
+  std::atomic_ref<int64_t>
+  position(size_t offset) const {
+    return std::atomic_ref(*reinterpret_cast<int64_t *>(data_ + offset));
+  }
+
+  uint8_t *
+  records() const {
+    return data_ + header_size;
+  }
+
+  std::atomic_ref<int32_t>
+  record_length(size_t index) const {
+    return std::atomic_ref(*reinterpret_cast<int32_t *>(records() + index));
+  }
+
+  int32_t &
+  record_type(size_t index) const {
+    return *reinterpret_cast<int32_t *>(records() + index + 4);
+  }
+
+  uint8_t *data_;
+  size_t capacity_;
+};
+
+template <typename T>
+struct java_type_info_t;
+
+template <>
+struct java_type_info_t<void> {
+  using type = void;
+
+  static constexpr java_string_literal_t signature = "V";
+};
+
+template <>
+struct java_type_info_t<bool> {
+  using type = jboolean;
+
+  static constexpr java_string_literal_t signature = "Z";
 
   static auto
   marshall(JNIEnv *env, bool value) {
@@ -1261,1099 +2063,3962 @@ struct java_type_info_t<std::string> {
   }
 };
 
-template <typename T>
-static auto
-java_marshall_value(JNIEnv *env, T value) {
-  return java_type_info_t<T>::marshall(env, value);
-}
+struct java_arena_t {
+  static constexpr size_t block_size = 64 * 1024;
 
-template <typename T>
-static jvalue
-java_marshall_argument_value(JNIEnv *env, T value) {
-  return jvalue{.l = reinterpret_cast<jobject>(java_marshall_value(env, value))};
-}
+  struct marker_t {
+    size_t block_;
+    size_t offset_;
+  };
 
-template <typename T>
-static auto
-java_unmarshall_value(JNIEnv *env, typename java_type_info_t<T>::type value) {
-  return java_type_info_t<T>::unmarshall(env, value);
-}
+  static java_arena_t &
+  get() {
+    static thread_local java_arena_t arena;
 
-struct java_env_t {
-  java_env_t() : vm_(nullptr), env_(nullptr), detach_(false) {}
+    return arena;
+  }
 
-  java_env_t(JavaVM *vm, JNIEnv *env, bool detach) : vm_(vm), env_(env), detach_(detach) {}
+  void *
+  allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+    while (true) {
+      if (block_ < blocks_.size()) {
+        auto &block = blocks_[block_];
 
-  java_env_t(JNIEnv *env) : vm_(nullptr), env_(env), detach_(false) {
-    env_->GetJavaVM(&vm_);
-  }
+        auto base = reinterpret_cast<uintptr_t>(block.data_.get());
 
-  java_env_t(java_env_t &&that) : java_env_t() {
-    swap(that);
-  }
+        auto start = (base + offset_ + alignment - 1) & ~(alignment - 1);
 
-  java_env_t(const java_env_t &) = delete;
+        if (start + size <= base + block.size_) {
+          offset_ = start + size - base;
 
-  ~java_env_t() {
-    if (detach_) vm_->DetachCurrentThread();
-  }
+          return reinterpret_cast<void *>(start);
+        }
 
-  java_env_t &
-  operator=(java_env_t &&that) {
-    swap(that);
+        block_++;
+        offset_ = 0;
+      } else {
+        auto n = std::max(block_size, size + alignment);
 
-    return *this;
+        blocks_.push_back({std::make_unique<uint8_t[]>(n), n});
+      }
+    }
   }
 
-  java_env_t &
-  operator=(const java_env_t &) = delete;
+  template <typename T>
+  std::span<T>
+  allocate(size_t count) {
+    return std::span<T>(static_cast<T *>(allocate(count * sizeof(T), alignof(T))), count);
+  }
 
-  operator JNIEnv *() const {
-    return env_;
+  marker_t
+  mark() const {
+    return {block_, offset_};
   }
 
   void
-  swap(java_env_t &that) {
-    std::swap(vm_, that.vm_);
-    std::swap(env_, that.env_);
-    std::swap(detach_, that.detach_);
+  release(marker_t marker) {
+    block_ = marker.block_;
+    offset_ = marker.offset_;
+  }
+
+  void
+  reset() {
+    block_ = 0;
+    offset_ = 0;
+  }
+
+  bool
+  scoped() const {
+    return depth_ != 0;
   }
 
 private:
-  JavaVM *vm_;
-  JNIEnv *env_;
-  bool detach_;
+  friend struct java_arena_scope_t;
+
+  struct block_t {
+    std::unique_ptr<uint8_t[]> data_;
+    size_t size_;
+  };
+
+  std::vector<block_t> blocks_;
+  size_t block_ = 0;
+  size_t offset_ = 0;
+  size_t depth_ = 0;
 };
 
-struct java_vm_t {
-  java_vm_t() : vm_(nullptr), destroy_(false) {}
+struct java_arena_scope_t {
+  java_arena_scope_t() : arena_(java_arena_t::get()), marker_(arena_.mark()) {
+    arena_.depth_++;
+  }
 
-  java_vm_t(JavaVM *vm, bool destroy) : vm_(vm), destroy_(destroy) {}
+  java_arena_scope_t(const java_arena_scope_t &) = delete;
 
-  java_vm_t(JavaVM *vm) : vm_(vm), destroy_(false) {}
+  ~java_arena_scope_t() {
+    arena_.depth_--;
 
-  java_vm_t(java_vm_t &&that) : java_vm_t() {
-    swap(that);
+    arena_.release(marker_);
   }
 
-  java_vm_t(const java_vm_t &) = delete;
+  java_arena_scope_t &
+  operator=(const java_arena_scope_t &) = delete;
 
-  ~java_vm_t() {
-    if (destroy_) vm_->DestroyJavaVM();
-  }
+private:
+  java_arena_t &arena_;
+  java_arena_t::marker_t marker_;
+};
 
-  java_vm_t &
-  operator=(java_vm_t &&that) {
-    swap(that);
+struct java_arena_string_t : std::string_view {
+  using std::string_view::string_view;
 
-    return *this;
+  const char *
+  c_str() const {
+    return data();
   }
+};
 
-  java_vm_t &
-  operator=(const java_vm_t &) = delete;
+template <typename T>
+struct java_arena_span_t : std::span<const T> {
+  using std::span<const T>::span;
+};
 
-  operator JavaVM *() const {
-    return vm_;
-  }
+template <>
+struct java_type_info_t<java_arena_string_t> {
+  using type = jobject;
 
-  void
-  swap(java_vm_t &that) {
-    std::swap(vm_, that.vm_);
-    std::swap(destroy_, that.destroy_);
+  static constexpr java_string_literal_t signature = "Ljava/lang/String;";
+
+  static auto
+  marshall(JNIEnv *env, const java_arena_string_t &value) {
+    return env->NewStringUTF(std::string(value).c_str());
   }
 
-  static std::optional<java_vm_t>
-  get_created() {
-    int err;
+  static java_arena_string_t
+  unmarshall(JNIEnv *env, const jobject &value) {
+    if (value == nullptr) return java_arena_string_t();
 
-    JavaVM *vm;
-    jsize len;
-    err = JNI_GetCreatedJavaVMs(&vm, 1, &len);
+    auto &arena = java_arena_t::get();
 
-    if (err != JNI_OK) return std::nullopt;
+    if (!arena.scoped()) throw std::logic_error("Arena values require an open arena scope");
 
-    return java_vm_t(vm, false);
-  }
+    auto string = reinterpret_cast<jstring>(value);
 
-  static std::pair<java_vm_t, java_env_t>
-  create(std::vector<std::string> options) {
-    int err;
+    auto length = static_cast<size_t>(env->GetStringUTFLength(string));
 
-    std::vector<JavaVMOption> vm_options;
+    auto data = arena.allocate<char>(length + 1);
 
-    vm_options.reserve(options.size());
+    env->GetStringUTFRegion(string, 0, env->GetStringLength(string), data.data());
 
-    for (const auto &option : options) {
-      vm_options.push_back({const_cast<char *>(option.c_str())});
-    }
+    data[length] = '\0';
 
-    JavaVMInitArgs vm_args;
+    return java_arena_string_t(data.data(), length);
+  }
+};
 
-    vm_args.version = JNI_VERSION_1_6;
-    vm_args.options = vm_options.data();
-    vm_args.nOptions = vm_options.size();
-    vm_args.ignoreUnrecognized = true;
+template <typename T>
+struct java_type_info_t<java_arena_span_t<T>> {
+  using type = jobject;
 
-    JavaVM *vm;
-    JNIEnv *env;
+  static constexpr java_string_literal_t signature = "[" + java_type_info_t<T>::signature;
 
-#if defined(__ANDROID__)
-    err = JNI_CreateJavaVM(&vm, &env, &vm_args);
-#else
-    err = JNI_CreateJavaVM(&vm, reinterpret_cast<void **>(&env), reinterpret_cast<void *>(&vm_args));
-#endif
+  static java_arena_span_t<T>
+  unmarshall(JNIEnv *env, const jobject &value) {
+    if (value == nullptr) return java_arena_span_t<T>();
 
-    if (err != JNI_OK) throw std::invalid_argument("Could not create VM");
+    auto &arena = java_arena_t::get();
 
-    return std::pair(java_vm_t(vm, true), java_env_t(vm, env, false));
-  }
+    if (!arena.scoped()) throw std::logic_error("Arena values require an open arena scope");
 
-  static auto
-  create(std::string options...) {
-    return create(std::vector({options}));
-  }
+    auto array = java_array_t<T>(env, value);
 
-  static auto
-  create() {
-    return create(std::vector<std::string>());
+    auto data = arena.allocate<T>(array.size());
+
+    array.copy_to(data);
+
+    return java_arena_span_t<T>(data.data(), data.size());
   }
+};
 
-  std::optional<java_env_t>
-  get_env() const {
-    int err;
+template <size_t L>
+struct java_enum_constant_t {
+  constexpr java_enum_constant_t(const char (&name)[L]) : name_(name), value_(0), positional_(true) {}
 
-    JNIEnv *env;
-    err = vm_->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
+  template <typename E>
+    requires std::is_enum_v<E>
+  constexpr java_enum_constant_t(E value, const char (&name)[L]) : name_(name), value_(static_cast<long long>(value)), positional_(false) {}
 
-    if (err != JNI_OK) return std::nullopt;
+  java_string_literal_t<L> name_;
+  long long value_;
+  bool positional_;
+};
 
-    return java_env_t(vm_, env, false);
-  }
+template <java_class_name_t N, typename E, java_enum_constant_t... C>
+  requires std::is_enum_v<E>
+struct java_enum_t {
+  static constexpr java_class_name_t name = N;
 
-  auto
-  attach_current_thread() const {
-    int err;
+  static constexpr auto values = [] {
+    std::array<long long, sizeof...(C)> values;
 
-    JNIEnv *env;
+    long long i = 0;
 
-#if defined(__ANDROID__)
-    err = vm_->AttachCurrentThread(&env, nullptr);
-#else
-    err = vm_->AttachCurrentThread(reinterpret_cast<void **>(&env), nullptr);
-#endif
+    ((values[i] = C.positional_ ? i : C.value_, i++), ...);
 
-    if (err != JNI_OK) throw std::invalid_argument("Could not attach current thread");
+    return values;
+  }();
 
-    return java_env_t(vm_, env, true);
-  }
+  static constexpr bool dense = [] {
+    for (size_t i = 0; i < values.size(); i++) {
+      if (values[i] != static_cast<long long>(i)) return false;
+    }
 
-private:
-  JavaVM *vm_;
-  bool destroy_;
-};
+    return true;
+  }();
 
-template <auto fn>
-struct java_callback_t;
+  jclass class_;
+  jmethodID ordinal_;
+  std::array<jobject, sizeof...(C)> constants_;
+  std::vector<std::optional<E>> ordinals_;
 
-template <typename T, typename... A, void fn(java_env_t, T, A...)>
-struct java_callback_t<fn> {
-  static constexpr java_string_literal_t signature = "(" + (java_type_info_t<A>::signature + ...) + ")V";
+  static const java_enum_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_enum_t info;
 
-  static constexpr auto
-  create() {
-    return +[](JNIEnv *env, typename java_type_info_t<T>::type receiver, typename java_type_info_t<A>::type... args) -> void {
-      return apply(env, receiver, std::move(args)...);
-    };
-  }
+      auto clazz = env->FindClass(N);
 
-  static constexpr auto
-  apply(JNIEnv *env, typename java_type_info_t<T>::type receiver, typename java_type_info_t<A>::type... args) {
-    fn(java_env_t(env), java_unmarshall_value<T>(env, std::move(receiver)), java_unmarshall_value<A>(env, std::move(args))...);
-  }
-};
+      if (clazz == nullptr) {
+        env->ExceptionClear();
 
-template <typename T, typename R, typename... A, R fn(java_env_t, T, A...)>
-struct java_callback_t<fn> {
-  static constexpr java_string_literal_t signature = "(" + (java_type_info_t<A>::signature + ...) + ")" + java_type_info_t<R>::signature;
+        throw std::invalid_argument("Could not find class with name '" + std::string(N) + "'");
+      }
 
-  static constexpr auto
-  create() {
-    return +[](JNIEnv *env, typename java_type_info_t<T>::type receiver, typename java_type_info_t<A>::type... args) -> typename java_type_info_t<R>::type {
-      return apply(env, receiver, std::move(args)...);
-    };
-  }
+      info.class_ = reinterpret_cast<jclass>(env->NewGlobalRef(clazz));
+      info.ordinal_ = env->GetMethodID(clazz, "ordinal", "()I");
 
-  static constexpr auto
-  apply(JNIEnv *env, typename java_type_info_t<T>::type receiver, typename java_type_info_t<A>::type... args) {
-    return java_marshall_value<R>(env, fn(java_env_t(env), java_unmarshall_value<T>(env, std::move(receiver)), java_unmarshall_value<A>(env, std::move(args))...));
-  }
-};
+      size_t i = 0;
 
-template <auto fn>
-struct java_type_info_t<java_callback_t<fn>> {
-  static constexpr java_string_literal_t signature = java_callback_t<fn>::signature;
-};
+      ([&] {
+        auto field = env->GetStaticFieldID(clazz, C.name_, "L" + N + ";");
 
-template <typename T>
-struct java_field_accessor_t;
+        if (field == nullptr) {
+          env->ExceptionClear();
 
-template <>
-struct java_field_accessor_t<bool> {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetBooleanField(receiver, field);
-  }
+          throw std::invalid_argument("Unknown enum constant '" + std::string(C.name_) + "'");
+        }
 
-  static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticBooleanField(receiver, field);
-  }
+        auto constant = env->GetStaticObjectField(clazz, field);
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jboolean value) {
-    env->SetBooleanField(receiver, field, value);
-  }
+        auto ordinal = static_cast<size_t>(env->CallIntMethod(constant, info.ordinal_));
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jboolean value) {
-    env->SetStaticBooleanField(receiver, field, value);
-  }
-};
+        if (ordinal >= info.ordinals_.size()) info.ordinals_.resize(ordinal + 1);
 
-template <>
-struct java_field_accessor_t<unsigned char> {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetByteField(receiver, field);
-  }
+        info.ordinals_[ordinal] = static_cast<E>(values[i]);
 
-  static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticByteField(receiver, field);
-  }
+        info.constants_[i++] = env->NewGlobalRef(constant);
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jbyte value) {
-    env->SetByteField(receiver, field, value);
-  }
+        env->DeleteLocalRef(constant);
+      }(),
+       ...);
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jbyte value) {
-    env->SetStaticByteField(receiver, field, value);
-  }
-};
+      env->DeleteLocalRef(clazz);
 
-template <>
-struct java_field_accessor_t<char> {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetCharField(receiver, field);
+      return info;
+    }(env);
+
+    return info;
   }
 
-  static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticCharField(receiver, field);
+  static E
+  unmarshall(JNIEnv *env, jobject value) {
+    auto &info = get(env);
+
+    auto ordinal = static_cast<size_t>(env->CallIntMethod(value, info.ordinal_));
+
+    if (ordinal >= info.ordinals_.size() || !info.ordinals_[ordinal]) {
+      throw std::invalid_argument("Unmapped enum ordinal " + std::to_string(ordinal));
+    }
+
+    return *info.ordinals_[ordinal];
   }
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jchar value) {
-    env->SetCharField(receiver, field, value);
+  static jobject
+  marshall(JNIEnv *env, E value) {
+    auto &info = get(env);
+
+    auto i = index(static_cast<long long>(value));
+
+    if (i >= info.constants_.size()) {
+      throw std::invalid_argument("Unmapped enum value " + std::to_string(static_cast<long long>(value)));
+    }
+
+    return info.constants_[i];
   }
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jchar value) {
-    env->SetStaticCharField(receiver, field, value);
+private:
+  static constexpr size_t
+  index(long long value) {
+    if constexpr (dense) {
+      return value < 0 ? values.size() : static_cast<size_t>(value);
+    } else {
+      for (size_t i = 0; i < values.size(); i++) {
+        if (values[i] == value) return i;
+      }
+
+      return values.size();
+    }
   }
 };
 
-template <>
-struct java_field_accessor_t<short> {
+template <typename E>
+struct java_enum_type_t;
+
+template <typename E>
+concept java_enum_type = std::is_enum_v<E> && requires { typename java_enum_type_t<E>::type; };
+
+template <java_enum_type E>
+struct java_type_info_t<E> {
+  using type = jobject;
+
+  using enumeration = typename java_enum_type_t<E>::type;
+
+  static constexpr java_string_literal_t signature = "L" + enumeration::name + ";";
+
   static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetShortField(receiver, field);
+  marshall(JNIEnv *env, E value) {
+    return enumeration::marshall(env, value);
   }
 
   static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticShortField(receiver, field);
+  unmarshall(JNIEnv *env, const jobject &value) {
+    return enumeration::unmarshall(env, value);
   }
+};
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jshort value) {
-    env->SetShortField(receiver, field, value);
-  }
+template <typename T>
+struct java_box_type_t;
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jshort value) {
-    env->SetStaticShortField(receiver, field, value);
+template <>
+struct java_box_type_t<bool> {
+  static constexpr java_class_name_t name = "java/lang/Boolean";
+  static constexpr java_string_literal_t value = "booleanValue";
+
+  static constexpr jlong cache_min = 0;
+  static constexpr jlong cache_max = 1;
+
+  static auto
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallBooleanMethod(object, method);
   }
 };
 
 template <>
-struct java_field_accessor_t<int> {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetIntField(receiver, field);
-  }
+struct java_box_type_t<unsigned char> {
+  static constexpr java_class_name_t name = "java/lang/Byte";
+  static constexpr java_string_literal_t value = "byteValue";
+
+  static constexpr jlong cache_min = -128;
+  static constexpr jlong cache_max = 127;
 
   static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticIntField(receiver, field);
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallByteMethod(object, method);
   }
+};
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jint value) {
-    env->SetIntField(receiver, field, value);
-  }
+template <>
+struct java_box_type_t<char> {
+  static constexpr java_class_name_t name = "java/lang/Character";
+  static constexpr java_string_literal_t value = "charValue";
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jint value) {
-    env->SetStaticIntField(receiver, field, value);
+  static constexpr jlong cache_min = 0;
+  static constexpr jlong cache_max = 127;
+
+  static auto
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallCharMethod(object, method);
   }
 };
 
 template <>
-struct java_field_accessor_t<long> {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetLongField(receiver, field);
-  }
+struct java_box_type_t<short> {
+  static constexpr java_class_name_t name = "java/lang/Short";
+  static constexpr java_string_literal_t value = "shortValue";
+
+  static constexpr jlong cache_min = -128;
+  static constexpr jlong cache_max = 127;
 
   static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticLongField(receiver, field);
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallShortMethod(object, method);
   }
+};
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jlong value) {
-    env->SetLongField(receiver, field, value);
-  }
+template <>
+struct java_box_type_t<int> {
+  static constexpr java_class_name_t name = "java/lang/Integer";
+  static constexpr java_string_literal_t value = "intValue";
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jlong value) {
-    env->SetStaticLongField(receiver, field, value);
+  static constexpr jlong cache_min = -128;
+  static constexpr jlong cache_max = 127;
+
+  static auto
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallIntMethod(object, method);
   }
 };
 
 template <>
-struct java_field_accessor_t<float> {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetFloatField(receiver, field);
-  }
+struct java_box_type_t<long> {
+  static constexpr java_class_name_t name = "java/lang/Long";
+  static constexpr java_string_literal_t value = "longValue";
+
+  static constexpr jlong cache_min = -128;
+  static constexpr jlong cache_max = 127;
 
   static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticFloatField(receiver, field);
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallLongMethod(object, method);
   }
+};
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jfloat value) {
-    env->SetFloatField(receiver, field, value);
-  }
+template <>
+struct java_box_type_t<long long> : java_box_type_t<long> {};
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jfloat value) {
-    env->SetStaticFloatField(receiver, field, value);
-  }
-};
+template <>
+struct java_box_type_t<unsigned long> : java_box_type_t<long> {};
 
 template <>
-struct java_field_accessor_t<double> {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return env->GetDoubleField(receiver, field);
-  }
+struct java_box_type_t<unsigned long long> : java_box_type_t<long> {};
+
+template <>
+struct java_box_type_t<float> {
+  static constexpr java_class_name_t name = "java/lang/Float";
+  static constexpr java_string_literal_t value = "floatValue";
+
+  static constexpr jlong cache_min = 0;
+  static constexpr jlong cache_max = -1;
 
   static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return env->GetStaticDoubleField(receiver, field);
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallFloatMethod(object, method);
   }
+};
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, jdouble value) {
-    env->SetDoubleField(receiver, field, value);
-  }
+template <>
+struct java_box_type_t<double> {
+  static constexpr java_class_name_t name = "java/lang/Double";
+  static constexpr java_string_literal_t value = "doubleValue";
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, jdouble value) {
-    env->SetStaticDoubleField(receiver, field, value);
+  static constexpr jlong cache_min = 0;
+  static constexpr jlong cache_max = -1;
+
+  static auto
+  unbox(JNIEnv *env, jobject object, jmethodID method) {
+    return env->CallDoubleMethod(object, method);
   }
 };
 
 template <typename T>
-struct java_field_accessor_t {
-  static auto
-  get(JNIEnv *env, jobject receiver, jfieldID field) {
-    return java_unmarshall_value<T>(env, env->GetObjectField(receiver, field));
-  }
+concept java_boxed_type = requires { java_box_type_t<T>::name; };
 
-  static auto
-  get(JNIEnv *env, jclass receiver, jfieldID field) {
-    return java_unmarshall_value<T>(env, env->GetStaticObjectField(receiver, field));
-  }
+template <java_boxed_type T>
+struct java_box_info_t {
+  using box_type = java_box_type_t<T>;
 
-  static void
-  set(JNIEnv *env, jobject receiver, jfieldID field, T value) {
-    env->SetObjectField(receiver, field, java_marshall_value(env, value));
-  }
+  static constexpr java_string_literal_t signature = java_type_info_t<T>::signature;
 
-  static void
-  set(JNIEnv *env, jclass receiver, jfieldID field, T value) {
-    env->SetStaticObjectField(receiver, field, java_marshall_value(value));
-  }
-};
+  jclass class_;
+  jmethodID value_of_;
+  jmethodID value_;
+  std::array<jobject, static_cast<size_t>(box_type::cache_max - box_type::cache_min + 1)> cache_;
 
-struct java_field_base_t {
-  java_field_base_t() : env_(nullptr), class_(nullptr), id_(nullptr) {}
+  static const java_box_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_box_info_t info;
 
-  java_field_base_t(JNIEnv *env, jclass clazz, jfieldID id) : env_(env), class_(clazz), id_(id) {}
+      auto clazz = env->FindClass(box_type::name);
 
-  java_field_base_t(java_field_base_t &&) = default;
+      info.class_ = reinterpret_cast<jclass>(env->NewGlobalRef(clazz));
+      info.value_of_ = env->GetStaticMethodID(clazz, "valueOf", "(" + signature + ")L" + box_type::name + ";");
+      info.value_ = env->GetMethodID(clazz, box_type::value, "()" + signature);
 
-  java_field_base_t(const java_field_base_t &) = delete;
+      for (size_t i = 0; i < info.cache_.size(); i++) {
+        auto value = static_cast<typename java_type_info_t<T>::type>(box_type::cache_min + static_cast<jlong>(i));
 
-  java_field_base_t &
-  operator=(java_field_base_t &&) = default;
+        auto object = env->CallStaticObjectMethod(clazz, info.value_of_, value);
 
-  java_field_base_t &
-  operator=(const java_field_base_t &) = delete;
+        info.cache_[i] = env->NewGlobalRef(object);
 
-  operator jfieldID() const {
-    return id_;
-  }
+        env->DeleteLocalRef(object);
+      }
+
+      env->DeleteLocalRef(clazz);
+
+      return info;
+    }(env);
+
+    return info;
+  }
+
+  jobject
+  box(JNIEnv *env, T value) const {
+    auto primitive = java_type_info_t<T>::marshall(env, value);
+
+    if constexpr (box_type::cache_max >= box_type::cache_min) {
+      auto n = static_cast<jlong>(primitive);
+
+      if (n >= box_type::cache_min && n <= box_type::cache_max) {
+        return cache_[static_cast<size_t>(n - box_type::cache_min)];
+      }
+    }
+
+    return env->CallStaticObjectMethod(class_, value_of_, primitive);
+  }
+
+  T
+  unbox(JNIEnv *env, jobject object) const {
+    return java_type_info_t<T>::unmarshall(env, box_type::unbox(env, object, value_));
+  }
+};
+
+template <typename T>
+struct java_type_info_t<std::optional<T>> {
+  using type = jobject;
+
+  static constexpr java_string_literal_t signature = java_type_info_t<T>::signature;
+
+  static jobject
+  marshall(JNIEnv *env, const std::optional<T> &value) {
+    if (!value) return nullptr;
+
+    return java_type_info_t<T>::marshall(env, *value);
+  }
+
+  static std::optional<T>
+  unmarshall(JNIEnv *env, const jobject &value) {
+    if (value == nullptr) return std::nullopt;
+
+    return java_type_info_t<T>::unmarshall(env, value);
+  }
+};
+
+template <java_boxed_type T>
+struct java_type_info_t<std::optional<T>> {
+  using type = jobject;
+
+  static constexpr java_string_literal_t signature = "L" + java_box_type_t<T>::name + ";";
+
+  static jobject
+  marshall(JNIEnv *env, const std::optional<T> &value) {
+    if (!value) return nullptr;
+
+    return java_box_info_t<T>::get(env).box(env, *value);
+  }
+
+  static std::optional<T>
+  unmarshall(JNIEnv *env, const jobject &value) {
+    if (value == nullptr) return std::nullopt;
+
+    return java_box_info_t<T>::get(env).unbox(env, value);
+  }
+};
+
+struct java_collection_info_t {
+  jclass object_;
+  jclass containers_;
+  jmethodID to_array_;
+  jmethodID list_;
+  jmethodID set_;
+  jmethodID map_;
+  jmethodID entries_;
+  jmethodID fill_;
+  jmethodID iterator_;
+
+  static const java_collection_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_collection_info_t info;
+
+      auto containers = env->FindClass("to/holepunch/jnitl/Containers");
+
+      if (containers == nullptr) {
+        env->ExceptionClear();
+
+        throw std::invalid_argument("Could not find class with name 'to/holepunch/jnitl/Containers'");
+      }
+
+      info.containers_ = reinterpret_cast<jclass>(env->NewGlobalRef(containers));
+      info.list_ = env->GetStaticMethodID(containers, "list", "([Ljava/lang/Object;)Ljava/util/List;");
+      info.set_ = env->GetStaticMethodID(containers, "set", "([Ljava/lang/Object;)Ljava/util/Set;");
+      info.map_ = env->GetStaticMethodID(containers, "map", "([Ljava/lang/Object;)Ljava/util/Map;");
+      info.entries_ = env->GetStaticMethodID(containers, "entries", "(Ljava/util/Map;)[Ljava/lang/Object;");
+      info.fill_ = env->GetStaticMethodID(containers, "fill", "(Ljava/util/Iterator;[Ljava/lang/Object;)I");
+
+      auto object = env->FindClass("java/lang/Object");
+
+      info.object_ = reinterpret_cast<jclass>(env->NewGlobalRef(object));
+
+      auto collection = env->FindClass("java/util/Collection");
+
+      info.to_array_ = env->GetMethodID(collection, "toArray", "()[Ljava/lang/Object;");
+
+      auto iterable = env->FindClass("java/lang/Iterable");
+
+      info.iterator_ = env->GetMethodID(iterable, "iterator", "()Ljava/util/Iterator;");
+
+      env->DeleteLocalRef(containers);
+      env->DeleteLocalRef(object);
+      env->DeleteLocalRef(collection);
+      env->DeleteLocalRef(iterable);
+
+      return info;
+    }(env);
+
+    return info;
+  }
+
+  template <typename F>
+  jobjectArray
+  scatter(JNIEnv *env, size_t length, F fn) const {
+    constexpr size_t batch = 256;
+
+    auto array = env->NewObjectArray(static_cast<jsize>(length), object_, nullptr);
+
+    for (size_t i = 0; i < length; i += batch) {
+      env->PushLocalFrame(static_cast<jint>(batch));
+
+      for (size_t j = i, n = std::min(length, i + batch); j < n; j++) {
+        env->SetObjectArrayElement(array, static_cast<jsize>(j), fn());
+      }
+
+      env->PopLocalFrame(nullptr);
+    }
+
+    return array;
+  }
+};
+
+template <typename T>
+static jobject
+java_marshall_element(JNIEnv *env, const T &value) {
+  if constexpr (java_boxed_type<T>) {
+    return java_box_info_t<T>::get(env).box(env, value);
+  } else {
+    return java_type_info_t<T>::marshall(env, value);
+  }
+}
+
+template <typename T>
+static T
+java_unmarshall_element(JNIEnv *env, jobject value) {
+  T result = [&] {
+    if constexpr (java_boxed_type<T>) {
+      return java_box_info_t<T>::get(env).unbox(env, value);
+    } else {
+      return java_type_info_t<T>::unmarshall(env, value);
+    }
+  }();
+
+  if constexpr (!java_reference_type<T>) env->DeleteLocalRef(value);
+
+  return result;
+}
+
+template <java_class_name_t N = "java/lang/Object">
+struct java_iterable_t {
+  struct iterator_t {
+    using value_type = java_object_t<N>;
+    using difference_type = std::ptrdiff_t;
+
+    value_type
+    operator*() const {
+      return java_object_t<N>(range_->env_, range_->env_->GetObjectArrayElement(range_->array_, static_cast<jsize>(range_->index_)));
+    }
+
+    iterator_t &
+    operator++() {
+      range_->advance();
+
+      return *this;
+    }
+
+    void
+    operator++(int) {
+      ++*this;
+    }
+
+    bool
+    operator==(std::default_sentinel_t) const {
+      return range_->index_ == range_->count_ && range_->exhausted_;
+    }
+
+    java_iterable_t *range_;
+  };
+
+  java_iterable_t(const java_object_t<"java/lang/Iterable"> &iterable, size_t batch = 64)
+      : env_(iterable.env()),
+        iterable_(iterable),
+        iterator_(nullptr),
+        array_(nullptr),
+        batch_(batch),
+        index_(0),
+        count_(0),
+        exhausted_(false) {
+    if (batch_ == 0) throw std::invalid_argument("Batch size must be positive");
+  }
+
+  java_iterable_t(const java_iterable_t &) = delete;
+
+  ~java_iterable_t() {
+    if (iterator_) env_->DeleteLocalRef(iterator_);
+    if (array_) env_->DeleteLocalRef(array_);
+  }
+
+  java_iterable_t &
+  operator=(const java_iterable_t &) = delete;
+
+  iterator_t
+  begin() {
+    if (iterator_ == nullptr) {
+      auto &info = java_collection_info_t::get(env_);
+
+      iterator_ = env_->CallObjectMethod(iterable_, info.iterator_);
+      array_ = env_->NewObjectArray(static_cast<jsize>(batch_), info.object_, nullptr);
+
+      fill();
+    }
+
+    return iterator_t{this};
+  }
+
+  std::default_sentinel_t
+  end() const {
+    return std::default_sentinel;
+  }
+
+private:
+  void
+  advance() {
+    if (++index_ == count_ && !exhausted_) fill();
+  }
+
+  void
+  fill();
 
-protected:
   JNIEnv *env_;
-  jclass class_;
-  jfieldID id_;
+  jobject iterable_;
+  jobject iterator_;
+  jobjectArray array_;
+  size_t batch_;
+  size_t index_;
+  size_t count_;
+  bool exhausted_;
+};
+
+template <typename T>
+struct java_list_t : std::vector<T> {
+  using std::vector<T>::vector;
+};
+
+template <typename C, java_class_name_t N, jmethodID java_collection_info_t::*M>
+struct java_collection_type_info_t {
+  using type = jobject;
+
+  using value_type = typename C::value_type;
+
+  static constexpr java_string_literal_t signature = "L" + N + ";";
+
+  static jobject
+  marshall(JNIEnv *env, const C &value) {
+    auto &info = java_collection_info_t::get(env);
+
+    auto it = value.begin();
+
+    auto array = info.scatter(env, value.size(), [&] { return java_marshall_element(env, *it++); });
+
+    auto result = env->CallStaticObjectMethod(info.containers_, info.*M, array);
+
+    env->DeleteLocalRef(array);
+
+    return result;
+  }
+
+  static C
+  unmarshall(JNIEnv *env, const jobject &value) {
+    C result;
+
+    if (value == nullptr) return result;
+
+    auto &info = java_collection_info_t::get(env);
+
+    auto array = reinterpret_cast<jobjectArray>(env->CallObjectMethod(value, info.to_array_));
+
+    auto length = env->GetArrayLength(array);
+
+    if constexpr (requires { result.reserve(0); }) result.reserve(length);
+
+    for (jsize i = 0; i < length; i++) {
+      result.insert(result.end(), java_unmarshall_element<value_type>(env, env->GetObjectArrayElement(array, i)));
+    }
+
+    env->DeleteLocalRef(array);
+
+    return result;
+  }
+};
+
+template <typename C>
+struct java_map_type_info_t {
+  using type = jobject;
+
+  using key_type = typename C::key_type;
+  using mapped_type = typename C::mapped_type;
+
+  static constexpr java_string_literal_t signature = "Ljava/util/Map;";
+
+  static jobject
+  marshall(JNIEnv *env, const C &value) {
+    auto &info = java_collection_info_t::get(env);
+
+    auto it = value.begin();
+
+    size_t i = 0;
+
+    auto array = info.scatter(env, value.size() * 2, [&] {
+      if (i++ % 2 == 0) return java_marshall_element(env, it->first);
+
+      return java_marshall_element(env, (it++)->second);
+    });
+
+    auto result = env->CallStaticObjectMethod(info.containers_, info.map_, array);
+
+    env->DeleteLocalRef(array);
+
+    return result;
+  }
+
+  static C
+  unmarshall(JNIEnv *env, const jobject &value) {
+    C result;
+
+    if (value == nullptr) return result;
+
+    auto &info = java_collection_info_t::get(env);
+
+    auto array = reinterpret_cast<jobjectArray>(env->CallStaticObjectMethod(info.containers_, info.entries_, value));
+
+    auto length = env->GetArrayLength(array);
+
+    if constexpr (requires { result.reserve(0); }) result.reserve(length / 2);
+
+    for (jsize i = 0; i + 1 < length; i += 2) {
+      auto key = java_unmarshall_element<key_type>(env, env->GetObjectArrayElement(array, i));
+
+      result.emplace(std::move(key), java_unmarshall_element<mapped_type>(env, env->GetObjectArrayElement(array, i + 1)));
+    }
+
+    env->DeleteLocalRef(array);
+
+    return result;
+  }
+};
+
+template <typename T>
+struct java_type_info_t<java_list_t<T>> : java_collection_type_info_t<java_list_t<T>, "java/util/List", &java_collection_info_t::list_> {};
+
+template <typename T>
+struct java_type_info_t<std::set<T>> : java_collection_type_info_t<std::set<T>, "java/util/Set", &java_collection_info_t::set_> {};
+
+template <typename T>
+struct java_type_info_t<std::unordered_set<T>> : java_collection_type_info_t<std::unordered_set<T>, "java/util/Set", &java_collection_info_t::set_> {};
+
+template <typename K, typename V>
+struct java_type_info_t<std::map<K, V>> : java_map_type_info_t<std::map<K, V>> {};
+
+template <typename K, typename V>
+struct java_type_info_t<std::unordered_map<K, V>> : java_map_type_info_t<std::unordered_map<K, V>> {};
+
+template <typename T>
+static auto
+java_marshall_value(JNIEnv *env, T value) {
+  return java_type_info_t<T>::marshall(env, value);
+}
+
+template <typename T>
+static jvalue
+java_marshall_argument_value(JNIEnv *env, T value) {
+  return jvalue{.l = reinterpret_cast<jobject>(java_marshall_value(env, value))};
+}
+
+template <typename T>
+static decltype(auto)
+java_unmarshall_value(JNIEnv *env, typename java_type_info_t<T>::type value) {
+  return java_type_info_t<T>::unmarshall(env, value);
+}
+
+struct java_env_t {
+  java_env_t() : vm_(nullptr), env_(nullptr), detach_(false) {}
+
+  java_env_t(JavaVM *vm, JNIEnv *env, bool detach) : vm_(vm), env_(env), detach_(detach) {}
+
+  java_env_t(JNIEnv *env) : vm_(nullptr), env_(env), detach_(false) {
+    env_->GetJavaVM(&vm_);
+  }
+
+  java_env_t(java_env_t &&that) : java_env_t() {
+    swap(that);
+  }
+
+  java_env_t(const java_env_t &) = delete;
+
+  ~java_env_t() {
+    if (detach_) vm_->DetachCurrentThread();
+  }
+
+  java_env_t &
+  operator=(java_env_t &&that) {
+    swap(that);
+
+    return *this;
+  }
+
+  java_env_t &
+  operator=(const java_env_t &) = delete;
+
+  operator JNIEnv *() const {
+    return env_;
+  }
+
+  void
+  swap(java_env_t &that) {
+    std::swap(vm_, that.vm_);
+    std::swap(env_, that.env_);
+    std::swap(detach_, that.detach_);
+  }
+
+private:
+  JavaVM *vm_;
+  JNIEnv *env_;
+  bool detach_;
+};
+
+#if JNITL_DYNAMIC_JVM
+struct java_jvm_library_t {
+  using create_java_vm_t = jint(JNICALL *)(JavaVM **, void **, void *);
+  using get_created_java_vms_t = jint(JNICALL *)(JavaVM **, jsize, jsize *);
+
+  create_java_vm_t create_java_vm_;
+  get_created_java_vms_t get_created_java_vms_;
+
+  static void
+  set_path(std::string path) {
+    std::scoped_lock lock(mutex());
+
+    configured_path() = std::move(path);
+  }
+
+  static const java_jvm_library_t &
+  get() {
+    static const auto library = [] {
+      java_jvm_library_t library;
+
+      if (auto loaded = find()) return *loaded;
+
+      auto path = java_jvm_library_t::path();
+
+      auto handle = dlopen(path.c_str(), RTLD_NOW | RTLD_GLOBAL);
+
+      if (handle == nullptr) {
+        throw std::invalid_argument("Could not load JVM library '" + path + "'");
+      }
+
+      library.create_java_vm_ = reinterpret_cast<create_java_vm_t>(dlsym(handle, "JNI_CreateJavaVM"));
+      library.get_created_java_vms_ = reinterpret_cast<get_created_java_vms_t>(dlsym(handle, "JNI_GetCreatedJavaVMs"));
+
+      if (library.create_java_vm_ == nullptr || library.get_created_java_vms_ == nullptr) {
+        throw std::invalid_argument("Could not find JNI invocation functions in JVM library '" + path + "'");
+      }
+
+      return library;
+    }();
+
+    return library;
+  }
+
+  static std::optional<java_jvm_library_t>
+  find() {
+    java_jvm_library_t library;
+
+    library.create_java_vm_ = reinterpret_cast<create_java_vm_t>(dlsym(RTLD_DEFAULT, "JNI_CreateJavaVM"));
+    library.get_created_java_vms_ = reinterpret_cast<get_created_java_vms_t>(dlsym(RTLD_DEFAULT, "JNI_GetCreatedJavaVMs"));
+
+    if (library.create_java_vm_ == nullptr || library.get_created_java_vms_ == nullptr) return std::nullopt;
+
+    return library;
+  }
+
+  static std::string
+  path() {
+    std::scoped_lock lock(mutex());
+
+    if (!configured_path().empty()) return configured_path();
+
+    if (auto path = getenv("JNITL_JVM_PATH")) return path;
+
+#if defined(__APPLE__)
+    constexpr auto name = "libjvm.dylib";
+#else
+    constexpr auto name = "libjvm.so";
+#endif
+
+    if (auto java_home = getenv("JAVA_HOME")) return std::string(java_home) + "/lib/server/" + name;
+
+    return name;
+  }
+
+private:
+  static std::mutex &
+  mutex() {
+    static std::mutex mutex;
+
+    return mutex;
+  }
+
+  static std::string &
+  configured_path() {
+#if defined(JNITL_JVM_PATH)
+    static std::string path = JNITL_JVM_PATH;
+#else
+    static std::string path;
+#endif
+
+    return path;
+  }
+};
+#endif
+
+struct java_vm_t {
+  java_vm_t() : vm_(nullptr), destroy_(false) {}
+
+  java_vm_t(JavaVM *vm, bool destroy) : vm_(vm), destroy_(destroy) {}
+
+  java_vm_t(JavaVM *vm) : vm_(vm), destroy_(false) {}
+
+  java_vm_t(java_vm_t &&that) : java_vm_t() {
+    swap(that);
+  }
+
+  java_vm_t(const java_vm_t &) = delete;
+
+  ~java_vm_t() {
+    if (destroy_) vm_->DestroyJavaVM();
+  }
+
+  java_vm_t &
+  operator=(java_vm_t &&that) {
+    swap(that);
+
+    return *this;
+  }
+
+  java_vm_t &
+  operator=(const java_vm_t &) = delete;
+
+  operator JavaVM *() const {
+    return vm_;
+  }
+
+  void
+  swap(java_vm_t &that) {
+    std::swap(vm_, that.vm_);
+    std::swap(destroy_, that.destroy_);
+  }
+
+  static std::optional<java_vm_t>
+  get_created() {
+    int err;
+
+    JavaVM *vm;
+    jsize len;
+
+#if JNITL_DYNAMIC_JVM
+    auto library = java_jvm_library_t::find();
+
+    if (!library) return std::nullopt;
+
+    err = library->get_created_java_vms_(&vm, 1, &len);
+#else
+    err = JNI_GetCreatedJavaVMs(&vm, 1, &len);
+#endif
+
+    if (err != JNI_OK || len == 0) return std::nullopt;
+
+    return java_vm_t(vm, false);
+  }
+
+  static std::pair<java_vm_t, java_env_t>
+  create(std::vector<std::string> options);
+
+  static auto
+  create(std::string options...) {
+    return create(std::vector({options}));
+  }
+
+  static auto
+  create() {
+    return create(std::vector<std::string>());
+  }
+
+  std::optional<java_env_t>
+  get_env() const {
+    int err;
+
+    JNIEnv *env;
+    err = vm_->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6);
+
+    if (err != JNI_OK) return std::nullopt;
+
+    return java_env_t(vm_, env, false);
+  }
+
+  auto
+  attach_current_thread() const {
+    int err;
+
+    JNIEnv *env;
+
+#if defined(__ANDROID__)
+    err = vm_->AttachCurrentThread(&env, nullptr);
+#else
+    err = vm_->AttachCurrentThread(reinterpret_cast<void **>(&env), nullptr);
+#endif
+
+    if (err != JNI_OK) throw std::invalid_argument("Could not attach current thread");
+
+    return java_env_t(vm_, env, true);
+  }
+
+private:
+  JavaVM *vm_;
+  bool destroy_;
+};
+
+struct java_vm_stats_t {
+  std::chrono::nanoseconds load;
+  std::chrono::nanoseconds create;
+  std::chrono::nanoseconds first_find_class;
+  std::chrono::nanoseconds first_class_load;
+  bool warmup_failed;
+};
+
+struct java_vm_builder_t {
+  using vfprintf_hook_t = jint(JNICALL *)(FILE *stream, const char *format, va_list args);
+  using exit_hook_t = void(JNICALL *)(jint code);
+  using abort_hook_t = void(JNICALL *)();
+
+  java_vm_builder_t()
+      : version_(JNI_VERSION_1_6),
+        ignore_unrecognized_(false),
+        vfprintf_(nullptr),
+        exit_(nullptr),
+        abort_(nullptr),
+        stats_() {}
+
+  java_vm_builder_t &
+  option(std::string option) {
+    if (option.empty() || option[0] != '-') {
+      throw std::invalid_argument("Invalid VM option '" + option + "'");
+    }
+
+    options_.push_back(std::move(option));
+
+    return *this;
+  }
+
+  java_vm_builder_t &
+  options(std::vector<std::string> options) {
+    for (auto &option : options) this->option(std::move(option));
+
+    return *this;
+  }
+
+  java_vm_builder_t &
+  property(const std::string &name, const std::string &value) {
+    if (name.empty() || name.find('=') != std::string::npos) {
+      throw std::invalid_argument("Invalid system property name '" + name + "'");
+    }
+
+    return option("-D" + name + "=" + value);
+  }
+
+  java_vm_builder_t &
+  class_path(const std::string &class_path) {
+    return property("java.class.path", class_path);
+  }
+
+  java_vm_builder_t &
+  version(jint version) {
+    if (version < JNI_VERSION_1_2) {
+      throw std::invalid_argument("Unsupported JNI version " + std::to_string(version));
+    }
+
+    version_ = version;
+
+    return *this;
+  }
+
+  java_vm_builder_t &
+  ignore_unrecognized(bool ignore = true) {
+    ignore_unrecognized_ = ignore;
+
+    return *this;
+  }
+
+  java_vm_builder_t &
+  on_vfprintf(vfprintf_hook_t hook) {
+    vfprintf_ = hook;
+
+    return *this;
+  }
+
+  java_vm_builder_t &
+  on_exit(exit_hook_t hook) {
+    exit_ = hook;
+
+    return *this;
+  }
+
+  java_vm_builder_t &
+  on_abort(abort_hook_t hook) {
+    abort_ = hook;
+
+    return *this;
+  }
+
+  java_vm_builder_t &
+  warmup_class(std::string class_name) {
+    warmup_class_ = std::move(class_name);
+
+    return *this;
+  }
+
+  std::pair<java_vm_t, java_env_t>
+  create() {
+    using clock = std::chrono::steady_clock;
+
+    int err;
+
+    std::vector<JavaVMOption> vm_options;
+
+    vm_options.reserve(options_.size() + 3);
+
+    for (const auto &option : options_) {
+      vm_options.push_back({.optionString = const_cast<char *>(option.c_str()), .extraInfo = nullptr});
+    }
+
+    if (vfprintf_) vm_options.push_back({.optionString = const_cast<char *>("vfprintf"), .extraInfo = reinterpret_cast<void *>(vfprintf_)});
+    if (exit_) vm_options.push_back({.optionString = const_cast<char *>("exit"), .extraInfo = reinterpret_cast<void *>(exit_)});
+    if (abort_) vm_options.push_back({.optionString = const_cast<char *>("abort"), .extraInfo = reinterpret_cast<void *>(abort_)});
+
+    JavaVMInitArgs vm_args;
+
+    vm_args.version = version_;
+    vm_args.options = vm_options.data();
+    vm_args.nOptions = vm_options.size();
+    vm_args.ignoreUnrecognized = ignore_unrecognized_;
+
+    JavaVM *vm;
+    JNIEnv *env;
+
+    stats_ = java_vm_stats_t();
+
+    auto start = clock::now();
+
+#if JNITL_DYNAMIC_JVM
+    auto &library = java_jvm_library_t::get();
+
+    stats_.load = clock::now() - start;
+
+    start = clock::now();
+
+    err = library.create_java_vm_(&vm, reinterpret_cast<void **>(&env), reinterpret_cast<void *>(&vm_args));
+#elif defined(__ANDROID__)
+    err = JNI_CreateJavaVM(&vm, &env, &vm_args);
+#else
+    err = JNI_CreateJavaVM(&vm, reinterpret_cast<void **>(&env), reinterpret_cast<void *>(&vm_args));
+#endif
+
+    stats_.create = clock::now() - start;
+
+    switch (err) {
+    case JNI_OK:
+      break;
+    case JNI_EVERSION:
+      throw std::invalid_argument("Could not create VM: unsupported JNI version " + std::to_string(version_));
+    case JNI_EINVAL:
+      throw std::invalid_argument("Could not create VM: invalid or unrecognized option");
+    case JNI_EEXIST:
+      throw std::invalid_argument("Could not create VM: a VM already exists");
+    case JNI_ENOMEM:
+      throw std::invalid_argument("Could not create VM: out of memory");
+    default:
+      throw std::invalid_argument("Could not create VM (error " + std::to_string(err) + ")");
+    }
+
+    if (!warmup_class_.empty()) warmup(env);
+
+    return std::pair(java_vm_t(vm, true), java_env_t(vm, env, false));
+  }
+
+  const java_vm_stats_t &
+  stats() const {
+    return stats_;
+  }
+
+private:
+  friend struct java_vm_t;
+
+  void
+  warmup(JNIEnv *env) {
+    using clock = std::chrono::steady_clock;
+
+    auto start = clock::now();
+
+    auto clazz = env->FindClass(warmup_class_.c_str());
+
+    stats_.first_find_class = clock::now() - start;
+
+    if (clazz == nullptr) {
+      env->ExceptionClear();
+
+      stats_.warmup_failed = true;
+
+      return;
+    }
+
+    auto class_class = env->FindClass("java/lang/Class");
+
+    auto get_class_loader = env->GetMethodID(class_class, "getClassLoader", "()Ljava/lang/ClassLoader;");
+    auto for_name = env->GetStaticMethodID(class_class, "forName", "(Ljava/lang/String;ZLjava/lang/ClassLoader;)Ljava/lang/Class;");
+
+    auto binary_name = warmup_class_;
+
+    for (auto &c : binary_name) {
+      if (c == '/') c = '.';
+    }
+
+    auto name = env->NewStringUTF(binary_name.c_str());
+    auto loader = env->CallObjectMethod(clazz, get_class_loader);
+
+    auto initialized = env->CallStaticObjectMethod(class_class, for_name, name, JNI_TRUE, loader);
+
+    stats_.first_class_load = clock::now() - start;
+
+    if (initialized == nullptr) {
+      env->ExceptionClear();
+
+      stats_.warmup_failed = true;
+    } else {
+      env->DeleteLocalRef(initialized);
+    }
+
+    env->DeleteLocalRef(loader);
+    env->DeleteLocalRef(name);
+    env->DeleteLocalRef(class_class);
+    env->DeleteLocalRef(clazz);
+  }
+
+  std::vector<std::string> options_;
+  jint version_;
+  bool ignore_unrecognized_;
+  vfprintf_hook_t vfprintf_;
+  exit_hook_t exit_;
+  abort_hook_t abort_;
+  std::string warmup_class_;
+  java_vm_stats_t stats_;
+};
+
+inline std::pair<java_vm_t, java_env_t>
+java_vm_t::create(std::vector<std::string> options) {
+  auto builder = java_vm_builder_t().ignore_unrecognized();
+
+  builder.options_ = std::move(options);
+
+  return builder.create();
+}
+
+struct java_throwable_info_t {
+  jmethodID get_message_;
+  jmethodID get_stack_trace_;
+  jmethodID get_class_;
+  jmethodID get_name_;
+  jmethodID to_string_;
+
+  static const java_throwable_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_throwable_info_t info;
+
+      auto object = env->FindClass("java/lang/Object");
+      auto clazz = env->FindClass("java/lang/Class");
+      auto throwable = env->FindClass("java/lang/Throwable");
+
+      info.get_message_ = env->GetMethodID(throwable, "getMessage", "()Ljava/lang/String;");
+      info.get_stack_trace_ = env->GetMethodID(throwable, "getStackTrace", "()[Ljava/lang/StackTraceElement;");
+      info.get_class_ = env->GetMethodID(object, "getClass", "()Ljava/lang/Class;");
+      info.get_name_ = env->GetMethodID(clazz, "getName", "()Ljava/lang/String;");
+      info.to_string_ = env->GetMethodID(object, "toString", "()Ljava/lang/String;");
+
+      env->DeleteLocalRef(throwable);
+      env->DeleteLocalRef(clazz);
+      env->DeleteLocalRef(object);
+
+      return info;
+    }(env);
+
+    return info;
+  }
+};
+
+struct java_exception_t : std::runtime_error {
+  java_exception_t(std::string class_name, std::string message, std::vector<std::string> stack_trace)
+      : std::runtime_error(message.empty() ? class_name : class_name + ": " + message),
+        class_name_(std::move(class_name)),
+        message_(std::move(message)),
+        stack_trace_(std::move(stack_trace)),
+        throwable_(nullptr) {}
+
+  java_exception_t(JNIEnv *env, jthrowable throwable, std::string class_name, std::string message, std::vector<std::string> stack_trace)
+      : java_exception_t(std::move(class_name), std::move(message), std::move(stack_trace)) {
+    JavaVM *vm;
+    env->GetJavaVM(&vm);
+
+    throwable_ = std::shared_ptr<std::remove_pointer_t<jthrowable>>(
+      reinterpret_cast<jthrowable>(env->NewGlobalRef(throwable)),
+      [vm](jthrowable throwable) {
+        JNIEnv *env;
+
+        if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) == JNI_OK) env->DeleteGlobalRef(throwable);
+      }
+    );
+  }
+
+  static java_exception_t
+  occurred(JNIEnv *env) {
+    auto throwable = env->ExceptionOccurred();
+
+    env->ExceptionClear();
+
+    auto &info = java_throwable_info_t::get(env);
+
+    auto clazz = env->CallObjectMethod(throwable, info.get_class_);
+
+    auto class_name = to_string(env, env->CallObjectMethod(clazz, info.get_name_));
+
+    auto message = to_string(env, env->CallObjectMethod(throwable, info.get_message_));
+
+    std::vector<std::string> stack_trace;
+
+    auto elements = reinterpret_cast<jobjectArray>(env->CallObjectMethod(throwable, info.get_stack_trace_));
+
+    if (elements) {
+      auto len = env->GetArrayLength(elements);
+
+      stack_trace.reserve(len);
+
+      for (jsize i = 0; i < len; i++) {
+        auto element = env->GetObjectArrayElement(elements, i);
+
+        stack_trace.push_back(to_string(env, env->CallObjectMethod(element, info.to_string_)));
+
+        env->DeleteLocalRef(element);
+      }
+
+      env->DeleteLocalRef(elements);
+    }
+
+    env->ExceptionClear();
+
+    auto result = java_exception_t(env, throwable, std::move(class_name), std::move(message), std::move(stack_trace));
+
+    env->DeleteLocalRef(clazz);
+    env->DeleteLocalRef(throwable);
+
+    return result;
+  }
+
+  jthrowable
+  throwable() const {
+    return throwable_.get();
+  }
+
+  const std::string &
+  class_name() const {
+    return class_name_;
+  }
+
+  const std::string &
+  message() const {
+    return message_;
+  }
+
+  const std::vector<std::string> &
+  stack_trace() const {
+    return stack_trace_;
+  }
+
+private:
+  static std::string
+  to_string(JNIEnv *env, jobject value) {
+    if (value == nullptr) return std::string();
+
+    auto result = java_unmarshall_value<std::string>(env, value);
+
+    env->DeleteLocalRef(value);
+
+    return result;
+  }
+
+  std::string class_name_;
+  std::string message_;
+  std::vector<std::string> stack_trace_;
+  std::shared_ptr<std::remove_pointer_t<jthrowable>> throwable_;
+};
+
+template <java_class_name_t N>
+void
+java_iterable_t<N>::fill() {
+  auto &info = java_collection_info_t::get(env_);
+
+  index_ = 0;
+  count_ = 0;
+  exhausted_ = true;
+
+  if (env_->ExceptionCheck()) throw java_exception_t::occurred(env_);
+
+  auto n = env_->CallStaticIntMethod(info.containers_, info.fill_, iterator_, array_);
+
+  if (env_->ExceptionCheck()) throw java_exception_t::occurred(env_);
+
+  count_ = static_cast<size_t>(n);
+  exhausted_ = count_ < batch_;
+}
+
+template <typename T>
+struct java_result_t {
+  java_result_t(T value) : result_(std::in_place_index<0>, std::move(value)) {}
+
+  java_result_t(java_exception_t error) : result_(std::in_place_index<1>, std::move(error)) {}
+
+  explicit operator bool() const {
+    return has_value();
+  }
+
+  T &
+  operator*() {
+    return std::get<0>(result_);
+  }
+
+  T *
+  operator->() {
+    return &std::get<0>(result_);
+  }
+
+  bool
+  has_value() const {
+    return result_.index() == 0;
+  }
+
+  T &
+  value() {
+    if (!has_value()) throw error();
+
+    return std::get<0>(result_);
+  }
+
+  const java_exception_t &
+  error() const {
+    return std::get<1>(result_);
+  }
+
+private:
+  std::variant<T, java_exception_t> result_;
+};
+
+template <>
+struct java_result_t<void> {
+  java_result_t() : error_(std::nullopt) {}
+
+  java_result_t(java_exception_t error) : error_(std::move(error)) {}
+
+  explicit operator bool() const {
+    return has_value();
+  }
+
+  bool
+  has_value() const {
+    return error_ == std::nullopt;
+  }
+
+  void
+  value() const {
+    if (error_) throw *error_;
+  }
+
+  const java_exception_t &
+  error() const {
+    return *error_;
+  }
+
+private:
+  std::optional<java_exception_t> error_;
+};
+
+struct java_exception_info_t {
+  jclass runtime_exception_;
+  jclass illegal_argument_exception_;
+  jclass illegal_state_exception_;
+  jclass index_out_of_bounds_exception_;
+  jclass arithmetic_exception_;
+  jclass out_of_memory_error_;
+
+  static const java_exception_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_exception_info_t info;
+
+      info.runtime_exception_ = resolve(env, "java/lang/RuntimeException");
+      info.illegal_argument_exception_ = resolve(env, "java/lang/IllegalArgumentException");
+      info.illegal_state_exception_ = resolve(env, "java/lang/IllegalStateException");
+      info.index_out_of_bounds_exception_ = resolve(env, "java/lang/IndexOutOfBoundsException");
+      info.arithmetic_exception_ = resolve(env, "java/lang/ArithmeticException");
+      info.out_of_memory_error_ = resolve(env, "java/lang/OutOfMemoryError");
+
+      return info;
+    }(env);
+
+    return info;
+  }
+
+private:
+  static jclass
+  resolve(JNIEnv *env, const char *name) {
+    auto clazz = env->FindClass(name);
+
+    auto ref = reinterpret_cast<jclass>(env->NewGlobalRef(clazz));
+
+    env->DeleteLocalRef(clazz);
+
+    return ref;
+  }
+};
+
+static inline void
+java_throw_current_exception(JNIEnv *env) noexcept {
+  auto &info = java_exception_info_t::get(env);
+
+  if (env->ExceptionCheck()) env->ExceptionClear();
+
+  try {
+    throw;
+  } catch (const java_exception_t &err) {
+    if (err.throwable()) env->Throw(err.throwable());
+    else env->ThrowNew(info.runtime_exception_, err.what());
+  } catch (const std::bad_alloc &err) {
+    env->ThrowNew(info.out_of_memory_error_, err.what());
+  } catch (const std::invalid_argument &err) {
+    env->ThrowNew(info.illegal_argument_exception_, err.what());
+  } catch (const std::out_of_range &err) {
+    env->ThrowNew(info.index_out_of_bounds_exception_, err.what());
+  } catch (const std::logic_error &err) {
+    env->ThrowNew(info.illegal_state_exception_, err.what());
+  } catch (const std::overflow_error &err) {
+    env->ThrowNew(info.arithmetic_exception_, err.what());
+  } catch (const std::underflow_error &err) {
+    env->ThrowNew(info.arithmetic_exception_, err.what());
+  } catch (const std::exception &err) {
+    env->ThrowNew(info.runtime_exception_, err.what());
+  } catch (...) {
+    env->ThrowNew(info.runtime_exception_, "Unknown C++ exception");
+  }
+}
+
+template <typename T>
+struct java_peer_type_t;
+
+template <typename T>
+  requires requires { typename T::java_peer; }
+struct java_peer_type_t<T> {
+  using type = typename T::java_peer;
+};
+
+template <typename T>
+concept java_peer_type = requires { typename java_peer_type_t<T>::type; };
+
+template <typename T>
+concept java_peer_reference = std::is_lvalue_reference_v<T> && java_peer_type<std::remove_cvref_t<T>>;
+
+struct java_epoch_guard_t;
+
+struct java_epoch_t {
+  static java_epoch_guard_t
+  enter();
+
+  static void
+  synchronize() {
+    std::lock_guard lock(mutex_);
+
+    auto epoch = epoch_.fetch_add(1, std::memory_order_seq_cst);
+
+    while (active_[epoch & 1].load(std::memory_order_acquire) != 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  static void
+  retire(void (*finalizer)(void *), void *peer) {
+    {
+      std::lock_guard lock(retired_mutex_);
+
+      retired_.push_back({finalizer, peer});
+
+      pending_.store(true, std::memory_order_release);
+    }
+
+    reclaim();
+  }
+
+  static void
+  reclaim() {
+    if (depth_ != 0) return;
+
+    std::vector<std::pair<void (*)(void *), void *>> batch;
+
+    {
+      std::lock_guard lock(retired_mutex_);
+
+      std::swap(batch, retired_);
+
+      pending_.store(false, std::memory_order_relaxed);
+    }
+
+    if (batch.empty()) return;
+
+    synchronize();
+
+    for (auto &[finalizer, peer] : batch) finalizer(peer);
+  }
+
+private:
+  friend struct java_epoch_guard_t;
+
+  static void
+  leave(std::atomic<size_t> *active) {
+    active->fetch_sub(1, std::memory_order_release);
+
+    if (--depth_ == 0 && pending_.load(std::memory_order_acquire)) reclaim();
+  }
+
+  static inline std::atomic<size_t> epoch_ = 0;
+  static inline std::atomic<size_t> active_[2] = {0, 0};
+  static inline std::mutex mutex_;
+  static inline std::vector<std::pair<void (*)(void *), void *>> retired_;
+  static inline std::atomic<bool> pending_ = false;
+  static inline std::mutex retired_mutex_;
+  static inline thread_local size_t depth_ = 0;
+};
+
+struct java_epoch_guard_t {
+  java_epoch_guard_t() : active_(nullptr) {}
+
+  java_epoch_guard_t(std::atomic<size_t> *active) : active_(active) {}
+
+  java_epoch_guard_t(java_epoch_guard_t &&that) : java_epoch_guard_t() {
+    std::swap(active_, that.active_);
+  }
+
+  java_epoch_guard_t(const java_epoch_guard_t &) = delete;
+
+  ~java_epoch_guard_t() {
+    if (active_) java_epoch_t::leave(active_);
+  }
+
+  java_epoch_guard_t &
+  operator=(java_epoch_guard_t &&that) {
+    std::swap(active_, that.active_);
+
+    return *this;
+  }
+
+  java_epoch_guard_t &
+  operator=(const java_epoch_guard_t &) = delete;
+
+private:
+  std::atomic<size_t> *active_;
+};
+
+inline java_epoch_guard_t
+java_epoch_t::enter() {
+  while (true) {
+    auto epoch = epoch_.load(std::memory_order_seq_cst);
+
+    auto &active = active_[epoch & 1];
+
+    active.fetch_add(1, std::memory_order_seq_cst);
+
+    if (epoch_.load(std::memory_order_seq_cst) == epoch) {
+      depth_++;
+
+      return java_epoch_guard_t(&active);
+    }
+
+    active.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+template <auto fn>
+struct java_callback_t;
+
+template <typename T, typename R, typename... A, bool E, R fn(java_env_t, T, A...) noexcept(E)>
+struct java_callback_t<fn> {
+  static constexpr java_string_literal_t signature = (java_string_literal_t("(") + ... + java_type_info_t<A>::signature) + ")" + java_type_info_t<R>::signature;
+
+  static constexpr bool is_noexcept = E;
+
+  static constexpr auto
+  create() {
+    return +[](JNIEnv *env, typename java_type_info_t<T>::type receiver, typename java_type_info_t<A>::type... args) noexcept -> typename java_type_info_t<R>::type {
+      if constexpr (E && !java_peer_reference<T> && !(java_peer_reference<A> || ...)) {
+        return apply(env, receiver, std::move(args)...);
+      } else {
+        try {
+          return apply(env, receiver, std::move(args)...);
+        } catch (...) {
+          java_throw_current_exception(env);
+
+          return typename java_type_info_t<R>::type();
+        }
+      }
+    };
+  }
+
+  static constexpr decltype(auto)
+  apply(JNIEnv *env, typename java_type_info_t<T>::type receiver, typename java_type_info_t<A>::type... args) {
+    java_arena_scope_t scope;
+
+    java_epoch_guard_t guard;
+
+    if constexpr (java_peer_reference<T> || (java_peer_reference<A> || ...)) guard = java_epoch_t::enter();
+
+    if constexpr (java_is_same<R, void>) {
+      fn(java_env_t(env), java_unmarshall_value<T>(env, std::move(receiver)), java_unmarshall_value<A>(env, std::move(args))...);
+    } else {
+      return java_marshall_value<R>(env, fn(java_env_t(env), java_unmarshall_value<T>(env, std::move(receiver)), java_unmarshall_value<A>(env, std::move(args))...));
+    }
+  }
+};
+
+template <typename T>
+concept java_primitive_type = !java_is_same<typename java_type_info_t<T>::type, jobject>;
+
+template <typename R, typename... A, bool E, R fn(A...) noexcept(E)>
+  requires java_primitive_type<R> && (java_primitive_type<A> && ...)
+struct java_callback_t<fn> {
+  static constexpr java_string_literal_t signature = (java_string_literal_t("(") + ... + java_type_info_t<A>::signature) + ")" + java_type_info_t<R>::signature;
+
+  static constexpr bool is_noexcept = E;
+
+  static constexpr auto
+  create() {
+    return +[](JNIEnv *env, jclass receiver, typename java_type_info_t<A>::type... args) noexcept -> typename java_type_info_t<R>::type {
+      if constexpr (E) {
+        return apply(env, args...);
+      } else {
+        try {
+          return apply(env, args...);
+        } catch (...) {
+          java_throw_current_exception(env);
+
+          return typename java_type_info_t<R>::type();
+        }
+      }
+    };
+  }
+
+  static constexpr auto
+  critical()
+    requires E
+  {
+    return +[](typename java_type_info_t<A>::type... args) noexcept -> typename java_type_info_t<R>::type {
+      return apply(nullptr, args...);
+    };
+  }
+
+  static constexpr decltype(auto)
+  apply(JNIEnv *env, typename java_type_info_t<A>::type... args) noexcept(E) {
+    if constexpr (java_is_same<R, void>) {
+      fn(java_unmarshall_value<A>(env, args)...);
+    } else {
+      return java_marshall_value<R>(env, fn(java_unmarshall_value<A>(env, args)...));
+    }
+  }
+};
+
+template <auto fn, typename C, typename R, bool E, typename... A>
+struct java_member_callback_t {
+  using peer = typename java_peer_type_t<std::remove_const_t<C>>::type;
+
+  static constexpr java_string_literal_t signature = (java_string_literal_t("(") + ... + java_type_info_t<A>::signature) + ")" + java_type_info_t<R>::signature;
+
+  static constexpr bool is_noexcept = E;
+
+  static void
+  prepare(JNIEnv *env) {
+    peer::field(env);
+  }
+
+  static constexpr auto
+  create() {
+    return +[](JNIEnv *env, jobject receiver, typename java_type_info_t<A>::type... args) noexcept -> typename java_type_info_t<R>::type {
+      auto guard = java_epoch_t::enter();
+
+      C *self = peer::try_get(env, receiver);
+
+      if (self == nullptr) {
+        env->ThrowNew(java_exception_info_t::get(env).illegal_state_exception_, "Native peer is closed");
+
+        return typename java_type_info_t<R>::type();
+      }
+
+      if constexpr (E && !(java_peer_reference<A> || ...)) {
+        return apply(env, *self, std::move(args)...);
+      } else {
+        try {
+          return apply(env, *self, std::move(args)...);
+        } catch (...) {
+          java_throw_current_exception(env);
+
+          return typename java_type_info_t<R>::type();
+        }
+      }
+    };
+  }
+
+  static constexpr decltype(auto)
+  apply(JNIEnv *env, C &self, typename java_type_info_t<A>::type... args) {
+    java_arena_scope_t scope;
+
+    if constexpr (java_is_same<R, void>) {
+      (self.*fn)(java_unmarshall_value<A>(env, std::move(args))...);
+    } else {
+      return java_marshall_value<R>(env, (self.*fn)(java_unmarshall_value<A>(env, std::move(args))...));
+    }
+  }
+};
+
+template <typename C, typename R, typename... A, bool E, R (C::*fn)(A...) noexcept(E)>
+struct java_callback_t<fn> : java_member_callback_t<fn, C, R, E, A...> {};
+
+template <typename C, typename R, typename... A, bool E, R (C::*fn)(A...) const noexcept(E)>
+struct java_callback_t<fn> : java_member_callback_t<fn, const C, R, E, A...> {};
+
+template <auto fn>
+struct java_type_info_t<java_callback_t<fn>> {
+  static constexpr java_string_literal_t signature = java_callback_t<fn>::signature;
+};
+
+template <typename T>
+struct java_field_accessor_t;
+
+template <>
+struct java_field_accessor_t<bool> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetBooleanField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticBooleanField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jboolean value) {
+    env->SetBooleanField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jboolean value) {
+    env->SetStaticBooleanField(receiver, field, value);
+  }
+};
+
+template <>
+struct java_field_accessor_t<unsigned char> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetByteField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticByteField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jbyte value) {
+    env->SetByteField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jbyte value) {
+    env->SetStaticByteField(receiver, field, value);
+  }
+};
+
+template <>
+struct java_field_accessor_t<char> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetCharField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticCharField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jchar value) {
+    env->SetCharField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jchar value) {
+    env->SetStaticCharField(receiver, field, value);
+  }
+};
+
+template <>
+struct java_field_accessor_t<short> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetShortField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticShortField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jshort value) {
+    env->SetShortField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jshort value) {
+    env->SetStaticShortField(receiver, field, value);
+  }
+};
+
+template <>
+struct java_field_accessor_t<int> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetIntField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticIntField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jint value) {
+    env->SetIntField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jint value) {
+    env->SetStaticIntField(receiver, field, value);
+  }
+};
+
+template <>
+struct java_field_accessor_t<long> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetLongField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticLongField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jlong value) {
+    env->SetLongField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jlong value) {
+    env->SetStaticLongField(receiver, field, value);
+  }
+};
+
+template <>
+struct java_field_accessor_t<float> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetFloatField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticFloatField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jfloat value) {
+    env->SetFloatField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jfloat value) {
+    env->SetStaticFloatField(receiver, field, value);
+  }
+};
+
+template <>
+struct java_field_accessor_t<double> {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return env->GetDoubleField(receiver, field);
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return env->GetStaticDoubleField(receiver, field);
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, jdouble value) {
+    env->SetDoubleField(receiver, field, value);
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, jdouble value) {
+    env->SetStaticDoubleField(receiver, field, value);
+  }
+};
+
+template <typename T>
+struct java_field_accessor_t {
+  static auto
+  get(JNIEnv *env, jobject receiver, jfieldID field) {
+    return java_unmarshall_value<T>(env, env->GetObjectField(receiver, field));
+  }
+
+  static auto
+  get(JNIEnv *env, jclass receiver, jfieldID field) {
+    return java_unmarshall_value<T>(env, env->GetStaticObjectField(receiver, field));
+  }
+
+  static void
+  set(JNIEnv *env, jobject receiver, jfieldID field, T value) {
+    env->SetObjectField(receiver, field, java_marshall_value(env, value));
+  }
+
+  static void
+  set(JNIEnv *env, jclass receiver, jfieldID field, T value) {
+    env->SetStaticObjectField(receiver, field, java_marshall_value(env, value));
+  }
+};
+
+static inline JNIEnv *
+java_current_env(JavaVM *vm) {
+  JNIEnv *env;
+
+  if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) {
+    throw std::invalid_argument("Current thread is not attached to the VM");
+  }
+
+  return env;
+}
+
+struct java_field_base_t {
+  java_field_base_t() : id_(nullptr) {}
+
+  java_field_base_t(jfieldID id) : id_(id) {}
+
+  operator jfieldID() const {
+    return id_;
+  }
+
+protected:
+  jfieldID id_;
+};
+
+struct java_static_field_base_t : java_field_base_t {
+  java_static_field_base_t() : java_field_base_t(), vm_(nullptr), class_() {}
+
+  java_static_field_base_t(JNIEnv *env, jclass clazz, jfieldID id) : java_field_base_t(id), vm_(nullptr), class_(env, clazz) {
+    env->GetJavaVM(&vm_);
+  }
+
+  operator jclass() const {
+    return reinterpret_cast<jclass>(static_cast<jobject>(class_));
+  }
+
+protected:
+  JavaVM *vm_;
+  java_shared_ref_t<java_object_t<"java/lang/Class">> class_;
+};
+
+template <java_class_name_t N, typename T>
+struct java_field_t : java_field_base_t {
+  auto
+  get(const java_object_t<N> &receiver) const {
+    return java_field_accessor_t<T>::get(receiver.env(), receiver, id_);
+  }
+
+  auto
+  get(JNIEnv *env, jobject receiver) const {
+    return java_field_accessor_t<T>::get(env, receiver, id_);
+  }
+
+  void
+  set(const java_object_t<N> &receiver, T value) const {
+    java_field_accessor_t<T>::set(receiver.env(), receiver, id_, value);
+  }
+
+  void
+  set(JNIEnv *env, jobject receiver, T value) const {
+    java_field_accessor_t<T>::set(env, receiver, id_, value);
+  }
+};
+
+template <java_class_name_t N, typename T>
+struct java_static_field_t : java_static_field_base_t {
+  auto
+  get() const {
+    return get(java_current_env(vm_));
+  }
+
+  auto
+  get(JNIEnv *env) const {
+    return java_field_accessor_t<T>::get(env, jclass(*this), id_);
+  }
+
+  void
+  set(T value) const {
+    set(java_current_env(vm_), value);
+  }
+
+  void
+  set(JNIEnv *env, T value) const {
+    java_field_accessor_t<T>::set(env, jclass(*this), id_, value);
+  }
+};
+
+template <java_class_name_t N, typename T>
+struct java_static_constant_t {
+  java_static_constant_t() : state_() {}
+
+  java_static_constant_t(JNIEnv *env, const java_static_field_t<N, T> &field) : state_(std::make_shared<state_t>(field)) {}
+
+  operator const T &() const {
+    return get();
+  }
+
+  const T &
+  get() const {
+    std::call_once(state_->once_, [this] {
+      state_->value_ = state_->field_.get();
+    });
+
+    return state_->value_;
+  }
+
+  const T &
+  get(JNIEnv *env) const {
+    std::call_once(state_->once_, [this, env] {
+      state_->value_ = state_->field_.get(env);
+    });
+
+    return state_->value_;
+  }
+
+private:
+  struct state_t {
+    state_t(const java_static_field_t<N, T> &field) : field_(field), value_() {}
+
+    java_static_field_t<N, T> field_;
+    std::once_flag once_;
+    T value_;
+  };
+
+  std::shared_ptr<state_t> state_;
+};
+
+template <java_class_name_t N, java_reference_type T>
+struct java_static_constant_t<N, T> {
+  java_static_constant_t() : state_() {}
+
+  java_static_constant_t(JNIEnv *env, const java_static_field_t<N, T> &field) : state_(std::make_shared<state_t>(field)) {}
+
+  operator jobject() const {
+    std::call_once(state_->once_, [this] {
+      state_->value_ = java_shared_ref_t<T>(state_->field_.get());
+    });
+
+    return state_->value_;
+  }
+
+  T
+  get(JNIEnv *env) const {
+    std::call_once(state_->once_, [this, env] {
+      state_->value_ = java_shared_ref_t<T>(state_->field_.get(env));
+    });
+
+    return state_->value_.get(env);
+  }
+
+private:
+  struct state_t {
+    state_t(const java_static_field_t<N, T> &field) : field_(field), value_() {}
+
+    java_static_field_t<N, T> field_;
+    std::once_flag once_;
+    java_shared_ref_t<T> value_;
+  };
+
+  std::shared_ptr<state_t> state_;
+};
+
+template <java_class_name_t N>
+template <typename T>
+T
+java_object_t<N>::get(const java_field_t<N, T> &field) const {
+  return field.get(*this);
+}
+
+template <java_class_name_t N>
+template <typename T>
+void
+java_object_t<N>::set(const java_field_t<N, T> &field, T value) const {
+  return field.set(*this, value);
+}
+
+struct java_unchecked_t {
+  template <typename R, typename F>
+  static R
+  check(JNIEnv *env, F fn) {
+    return fn();
+  }
+};
+
+struct java_checked_t {
+  template <typename R, typename F>
+  static R
+  check(JNIEnv *env, F fn) {
+    if (env->ExceptionCheck()) throw java_exception_t::occurred(env);
+
+    return fn();
+  }
+};
+
+struct java_expected_t {
+  template <typename R, typename F>
+  static java_result_t<R>
+  check(JNIEnv *env, F fn) {
+    if (env->ExceptionCheck()) return java_exception_t::occurred(env);
+
+    if constexpr (java_is_same<R, void>) return java_result_t<void>();
+    else return fn();
+  }
+};
+
+template <typename T, typename P = java_unchecked_t>
+struct java_method_invoker_t;
+
+template <typename P, typename... A>
+struct java_method_invoker_t<void(A...), P> {
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    env->CallVoidMethodA(receiver, method, argv);
+
+    return P::template check<void>(env, [] {});
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    env->CallStaticVoidMethodA(receiver, method, argv);
+
+    return P::template check<void>(env, [] {});
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    env->CallNonvirtualVoidMethodA(receiver, clazz, method, argv);
+
+    return P::template check<void>(env, [] {});
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<bool(A...), P> {
+  using R = bool;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallBooleanMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticBooleanMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualBooleanMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<unsigned char(A...), P> {
+  using R = unsigned char;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallByteMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticByteMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualByteMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<char(A...), P> {
+  using R = char;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallCharMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticCharMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualCharMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<short(A...), P> {
+  using R = short;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallShortMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticShortMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualShortMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<int(A...), P> {
+  using R = int;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallIntMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticIntMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualIntMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<long(A...), P> {
+  using R = long;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallLongMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticLongMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualLongMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<float(A...), P> {
+  using R = float;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallFloatMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticFloatMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualFloatMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename P, typename... A>
+struct java_method_invoker_t<double(A...), P> {
+  using R = double;
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallDoubleMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticDoubleMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualDoubleMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return static_cast<R>(result); });
+  }
+};
+
+template <typename R, typename P, typename... A>
+struct java_method_invoker_t<R(A...), P> {
+  static auto
+  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallObjectMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return java_unmarshall_value<R>(env, result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallStaticObjectMethodA(receiver, method, argv);
+
+    return P::template check<R>(env, [&] { return java_unmarshall_value<R>(env, result); });
+  }
+
+  static auto
+  call(JNIEnv *env, jobject receiver, jclass clazz, jmethodID method, A... args) {
+    jvalue argv[] = {
+      java_marshall_argument_value(env, std::move(args))...
+    };
+
+    auto result = env->CallNonvirtualObjectMethodA(receiver, clazz, method, argv);
+
+    return P::template check<R>(env, [&] { return java_unmarshall_value<R>(env, result); });
+  }
+};
+
+struct java_method_base_t {
+  java_method_base_t() : id_(nullptr) {}
+
+  java_method_base_t(jmethodID id) : id_(id) {}
+
+  operator jmethodID() const {
+    return id_;
+  }
+
+protected:
+  jmethodID id_;
+};
+
+struct java_static_method_base_t : java_method_base_t {
+  java_static_method_base_t() : java_method_base_t(), vm_(nullptr), class_() {}
+
+  java_static_method_base_t(JNIEnv *env, jclass clazz, jmethodID id) : java_method_base_t(id), vm_(nullptr), class_(env, clazz) {
+    env->GetJavaVM(&vm_);
+  }
+
+  operator jclass() const {
+    return reinterpret_cast<jclass>(static_cast<jobject>(class_));
+  }
+
+protected:
+  JavaVM *vm_;
+  java_shared_ref_t<java_object_t<"java/lang/Class">> class_;
+};
+
+template <java_class_name_t, typename, typename>
+struct java_method_t;
+
+template <java_class_name_t N, typename P, typename... A>
+struct java_method_t<N, void(A...), P> : java_method_base_t {
+  auto call(const java_object_t<N> &receiver, A... args) const {
+    return java_method_invoker_t<void(A...), P>::call(receiver.env(), receiver, id_, std::move(args)...);
+  }
+
+  auto call(JNIEnv *env, jobject receiver, A... args) const {
+    return java_method_invoker_t<void(A...), P>::call(env, receiver, id_, std::move(args)...);
+  }
+
+  auto operator()(const java_object_t<N> &receiver, A... args) const {
+    return call(receiver, std::move(args)...);
+  }
+};
+
+template <java_class_name_t N, typename R, typename P, typename... A>
+struct java_method_t<N, R(A...), P> : java_method_base_t {
+  auto call(const java_object_t<N> &receiver, A... args) const {
+    return java_method_invoker_t<R(A...), P>::call(receiver.env(), receiver, id_, std::move(args)...);
+  }
+
+  auto call(JNIEnv *env, jobject receiver, A... args) const {
+    return java_method_invoker_t<R(A...), P>::call(env, receiver, id_, std::move(args)...);
+  }
+
+  auto operator()(const java_object_t<N> &receiver, A... args) const {
+    return call(receiver, std::move(args)...);
+  }
+};
+
+template <java_class_name_t N>
+template <typename P, typename... A>
+auto
+java_object_t<N>::apply(const java_method_t<N, void(A...), P> &method, A... args) const {
+  return method(*this, std::move(args)...);
+}
+
+template <java_class_name_t N>
+template <typename R, typename P, typename... A>
+auto
+java_object_t<N>::apply(const java_method_t<N, R(A...), P> &method, A... args) const {
+  return method(*this, std::move(args)...);
+}
+
+template <typename T, typename P = java_unchecked_t>
+struct java_static_method_t;
+
+template <typename P, typename... A>
+struct java_static_method_t<void(A...), P> : java_static_method_base_t {
+  auto call(A... args) const {
+    return call(java_current_env(vm_), std::move(args)...);
+  }
+
+  auto call(JNIEnv *env, A... args) const {
+    return java_method_invoker_t<void(A...), P>::call(env, jclass(*this), id_, std::move(args)...);
+  }
+
+  auto operator()(A... args) const {
+    return call(std::move(args)...);
+  }
+};
+
+template <typename R, typename P, typename... A>
+struct java_static_method_t<R(A...), P> : java_static_method_base_t {
+  auto call(A... args) const {
+    return call(java_current_env(vm_), std::move(args)...);
+  }
+
+  auto call(JNIEnv *env, A... args) const {
+    return java_method_invoker_t<R(A...), P>::call(env, jclass(*this), id_, std::move(args)...);
+  }
+
+  auto operator()(A... args) const {
+    return call(std::move(args)...);
+  }
+};
+
+template <java_class_name_t N, typename T, typename P = java_unchecked_t>
+struct java_nonvirtual_method_t;
+
+template <java_class_name_t N, typename P, typename... A>
+struct java_nonvirtual_method_t<N, void(A...), P> : java_static_method_base_t {
+  auto call(const java_object_t<N> &receiver, A... args) const {
+    return java_method_invoker_t<void(A...), P>::call(receiver.env(), receiver, jclass(*this), id_, std::move(args)...);
+  }
+
+  auto call(JNIEnv *env, jobject receiver, A... args) const {
+    return java_method_invoker_t<void(A...), P>::call(env, receiver, jclass(*this), id_, std::move(args)...);
+  }
+
+  auto operator()(const java_object_t<N> &receiver, A... args) const {
+    return call(receiver, std::move(args)...);
+  }
+};
+
+template <java_class_name_t N, typename R, typename P, typename... A>
+struct java_nonvirtual_method_t<N, R(A...), P> : java_static_method_base_t {
+  auto call(const java_object_t<N> &receiver, A... args) const {
+    return java_method_invoker_t<R(A...), P>::call(receiver.env(), receiver, jclass(*this), id_, std::move(args)...);
+  }
+
+  auto call(JNIEnv *env, jobject receiver, A... args) const {
+    return java_method_invoker_t<R(A...), P>::call(env, receiver, jclass(*this), id_, std::move(args)...);
+  }
+
+  auto operator()(const java_object_t<N> &receiver, A... args) const {
+    return call(receiver, std::move(args)...);
+  }
+};
+
+template <auto fn, java_string_literal_t F>
+struct java_native_method_t {
+  static constexpr java_string_literal_t name = F;
+
+  static constexpr java_string_literal_t signature = java_callback_t<fn>::signature;
+
+  static void *
+  pointer() {
+    return reinterpret_cast<void *>(java_callback_t<fn>::create());
+  }
+
+  static void
+  prepare(JNIEnv *env) {
+    if constexpr (requires { java_callback_t<fn>::prepare(env); }) java_callback_t<fn>::prepare(env);
+  }
+};
+
+template <auto fn, java_string_literal_t F>
+struct java_critical_native_method_t : java_native_method_t<fn, F> {
+  static_assert(requires { java_callback_t<fn>::critical(); }, "Critical native methods must be noexcept and take and return only primitives");
+
+  static void *
+  pointer() {
+#if defined(__ANDROID__) && __ANDROID_API__ >= 26
+    return reinterpret_cast<void *>(java_callback_t<fn>::critical());
+#else
+    return java_native_method_t<fn, F>::pointer();
+#endif
+  }
+};
+
+template <typename T>
+constexpr bool java_is_native_method = false;
+
+template <auto fn, java_string_literal_t F>
+constexpr bool java_is_native_method<java_native_method_t<fn, F>> = true;
+
+template <auto fn, java_string_literal_t F>
+constexpr bool java_is_native_method<java_critical_native_method_t<fn, F>> = true;
+
+template <typename T>
+concept java_native_method = java_is_native_method<T>;
+
+template <java_class_name_t N, typename T = java_object_t<N>>
+struct java_class_t : java_object_t<"java/lang/Class"> {
+  java_class_t() : java_object_t() {}
+
+  java_class_t(JNIEnv *env, jobject clazz) : java_object_t(env, clazz) {}
+
+  java_class_t(JNIEnv *env) : java_object_t(env, nullptr) {
+    handle_ = env_->FindClass(N);
+
+    if (handle_ == nullptr) {
+      env_->ExceptionClear();
+
+      throw std::invalid_argument("Could not find class with name '" + std::string(name) + "'");
+    }
+  }
+
+  java_class_t(java_class_t &&that) {
+    swap(that);
+  }
+
+  java_class_t(const java_class_t &that) : java_object_t(that) {}
+
+  java_class_t &
+  operator=(java_class_t that) {
+    swap(that);
+
+    return *this;
+  }
+
+  operator jclass() const {
+    return reinterpret_cast<jclass>(handle_);
+  }
+
+  template <typename... A>
+  T operator()(A... args) const {
+    auto init = get_method<void(A...)>("<init>");
+
+    jvalue argv[] = {
+      java_marshall_argument_value(env_, std::move(args))...
+    };
+
+    return T(env_, env_->NewObjectA(jclass(handle_), init, argv));
+  }
+
+  template <typename U>
+  auto
+  get_field(const char *name) const {
+    auto signature = java_type_info_t<U>::signature.c_str();
+
+    auto id = env_->GetFieldID(jclass(handle_), name, signature);
+
+    if (id == nullptr) {
+      throw std::invalid_argument(
+        "Could not find field '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
+      );
+    }
+
+    return java_field_t<N, U>(java_field_base_t(id));
+  }
+
+  template <typename U>
+  auto
+  get_field(std::string name) const {
+    return get_field<U>(name.c_str());
+  }
+
+  template <typename U>
+  auto
+  get_static_field(const char *name) const {
+    auto signature = java_type_info_t<U>::signature.c_str();
+
+    auto id = env_->GetStaticFieldID(jclass(handle_), name, signature);
+
+    if (id == nullptr) {
+      throw std::invalid_argument(
+        "Could not find field '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
+      );
+    }
+
+    return java_static_field_t<N, U>(java_static_field_base_t(env_, jclass(handle_), id));
+  }
+
+  template <typename U>
+  auto
+  get_static_field(std::string name) const {
+    return get_static_field<U>(name.c_str());
+  }
+
+  template <typename U>
+  auto
+  get_constant(const char *name) const {
+    return java_static_constant_t<N, U>(env_, get_static_field<U>(name));
+  }
+
+  template <typename U>
+  auto
+  get_constant(std::string name) const {
+    return get_constant<U>(name.c_str());
+  }
+
+  template <typename U, typename P = java_unchecked_t>
+  auto
+  get_method(const char *name) const {
+    auto signature = java_type_info_t<U>::signature.c_str();
+
+    auto id = env_->GetMethodID(jclass(handle_), name, signature);
+
+    if (id == nullptr) {
+      throw std::invalid_argument(
+        "Could not find method '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
+      );
+    }
+
+    return java_method_t<N, U, P>(java_method_base_t(id));
+  }
+
+  template <typename U, typename P = java_unchecked_t>
+  auto
+  get_method(std::string name) const {
+    return get_method<U, P>(name.c_str());
+  }
+
+  template <typename U, typename P = java_unchecked_t>
+  auto
+  get_nonvirtual_method(const char *name) const {
+    auto signature = java_type_info_t<U>::signature.c_str();
+
+    auto id = env_->GetMethodID(jclass(handle_), name, signature);
+
+    if (id == nullptr) {
+      throw std::invalid_argument(
+        "Could not find method '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
+      );
+    }
+
+    return java_nonvirtual_method_t<N, U, P>(java_static_method_base_t(env_, jclass(handle_), id));
+  }
+
+  template <typename U, typename P = java_unchecked_t>
+  auto
+  get_nonvirtual_method(std::string name) const {
+    return get_nonvirtual_method<U, P>(name.c_str());
+  }
+
+  template <typename U, typename P = java_unchecked_t>
+  auto
+  get_static_method(const char *name) const {
+    auto signature = java_type_info_t<U>::signature.c_str();
+
+    auto id = env_->GetStaticMethodID(jclass(handle_), name, signature);
+
+    if (id == nullptr) {
+      throw std::invalid_argument(
+        "Could not find method '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
+      );
+    }
+
+    return java_static_method_t<U, P>(java_static_method_base_t(env_, jclass(handle_), id));
+  }
+
+  template <typename U, typename P = java_unchecked_t>
+  auto
+  get_static_method(std::string name) const {
+    return get_static_method<U, P>(name.c_str());
+  }
+
+  template <typename U>
+  U
+  get(const java_static_field_t<N, U> &field) const {
+    return java_field_accessor_t<U>::get(env_, jclass(handle_), field);
+  }
+
+  template <typename U>
+  void
+  set(const java_static_field_t<N, U> &field, const U &value) const {
+    java_field_accessor_t<U>::set(env_, jclass(handle_), field, value);
+  }
+
+  template <typename P, typename... A>
+  auto
+  apply(const java_static_method_t<void(A...), P> &method, A... args) const {
+    return method(std::move(args)...);
+  }
+
+  template <typename R, typename P, typename... A>
+  auto
+  apply(const java_static_method_t<R(A...), P> &method, A... args) const {
+    return method(std::move(args)...);
+  }
+
+  template <java_native_method... M>
+  void
+  register_natives() {
+    java_exception_info_t::get(env_);
+
+    (M::prepare(env_), ...);
+
+    static const JNINativeMethod methods[] = {
+      {
+        .name = const_cast<char *>(M::name.c_str()),
+        .signature = const_cast<char *>(M::signature.c_str()),
+        .fnPtr = M::pointer(),
+      }...,
+    };
+
+    auto err = env_->RegisterNatives(jclass(handle_), methods, sizeof...(M));
+
+    if (err != JNI_OK) {
+      env_->ExceptionClear();
+
+      throw std::invalid_argument("Could not register natives for class with name '" + std::string(N) + "' (error " + std::to_string(err) + ")");
+    }
+  }
+
+  template <java_native_method... M>
+  void
+  register_natives(M...) {
+    register_natives<M...>();
+  }
+
+  void
+  unregister_natives() {
+    env_->UnregisterNatives(jclass(handle_));
+  }
+};
+
+template <typename T>
+struct java_member_pointer_t;
+
+template <typename C, typename T>
+struct java_member_pointer_t<T C::*> {
+  using class_type = C;
+  using type = T;
 };
 
-template <java_class_name_t N, typename T>
-struct java_field_t : java_field_base_t {
-  auto
-  get(const java_object_t<N> &receiver) const {
-    return java_field_accessor_t<T>::get(env_, receiver, id_);
+template <auto M, java_string_literal_t F>
+struct java_member_t {
+  static constexpr auto member = M;
+  static constexpr java_string_literal_t name = F;
+
+  using type = typename java_member_pointer_t<decltype(M)>::type;
+};
+
+template <java_class_name_t N, typename T, typename... M>
+struct java_struct_t {
+  java_struct_t() : ids_{} {}
+
+  java_struct_t(JNIEnv *env) : java_struct_t(java_class_t<N>(env)) {}
+
+  java_struct_t(const java_class_t<N> &clazz) : ids_{clazz.template get_field<typename M::type>(M::name.c_str())...} {}
+
+  void
+  read(JNIEnv *env, jobject receiver, T &out) const {
+    read(env, receiver, out, std::index_sequence_for<M...>());
   }
 
   void
-  set(const java_object_t<N> &receiver, T value) const {
-    java_field_accessor_t<T>::set(env_, receiver, id_, value);
+  read(const java_object_t<N> &receiver, T &out) const {
+    read(receiver.env(), receiver, out);
   }
-};
 
-template <java_class_name_t N, typename T>
-struct java_static_field_t : java_field_base_t {
-  auto
-  get() const {
-    return java_field_accessor_t<T>::get(env_, class_, id_);
+  T
+  read(const java_object_t<N> &receiver) const {
+    T out;
+
+    read(receiver, out);
+
+    return out;
   }
 
   void
-  set(T value) const {
-    java_field_accessor_t<T>::set(env_, class_, id_, value);
+  read(JNIEnv *env, jobjectArray receivers, std::span<T> out) const {
+    for (size_t i = 0, n = out.size(); i < n; i++) {
+      auto receiver = env->GetObjectArrayElement(receivers, i);
+
+      read(env, receiver, out[i]);
+
+      env->DeleteLocalRef(receiver);
+    }
   }
-};
 
-template <java_class_name_t N>
-template <typename T>
-T
-java_object_t<N>::get(const java_field_t<N, T> &field) const {
-  return field.get(*this);
-}
+  std::vector<T>
+  read(const java_array_t<java_object_t<N>> &receivers) const {
+    std::vector<T> out(receivers.size());
 
-template <java_class_name_t N>
-template <typename T>
-void
-java_object_t<N>::set(const java_field_t<N, T> &field, T value) const {
-  return field.set(*this, value);
-}
+    read(receivers.env(), receivers, std::span(out));
 
-template <typename T>
-struct java_method_invoker_t;
+    return out;
+  }
 
-template <typename... A>
-struct java_method_invoker_t<void(A...)> {
-  static void
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  void
+  write(JNIEnv *env, jobject receiver, const T &in) const {
+    write(env, receiver, in, std::index_sequence_for<M...>());
+  }
 
-    env->CallVoidMethodA(receiver, method, argv);
+  void
+  write(const java_object_t<N> &receiver, const T &in) const {
+    write(receiver.env(), receiver, in);
   }
 
-  static void
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  void
+  write(JNIEnv *env, jobjectArray receivers, std::span<const T> in) const {
+    for (size_t i = 0, n = in.size(); i < n; i++) {
+      auto receiver = env->GetObjectArrayElement(receivers, i);
 
-    env->CallStaticVoidMethodA(receiver, method, argv);
+      write(env, receiver, in[i]);
+
+      env->DeleteLocalRef(receiver);
+    }
+  }
+
+  void
+  write(const java_array_t<java_object_t<N>> &receivers, std::span<const T> in) const {
+    write(receivers.env(), receivers, in);
+  }
+
+private:
+  template <size_t... I>
+  void
+  read(JNIEnv *env, jobject receiver, T &out, std::index_sequence<I...>) const {
+    ((out.*M::member = java_field_accessor_t<typename M::type>::get(env, receiver, ids_[I])), ...);
+  }
+
+  template <size_t... I>
+  void
+  write(JNIEnv *env, jobject receiver, const T &in, std::index_sequence<I...>) const {
+    (java_field_accessor_t<typename M::type>::set(env, receiver, ids_[I], in.*M::member), ...);
   }
+
+  std::array<jfieldID, sizeof...(M)> ids_;
 };
 
-template <typename... A>
-struct java_method_invoker_t<bool(A...)> {
-  static bool
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+struct java_class_loader_t : java_object_t<"java/lang/ClassLoader"> {
+  java_class_loader_t() : java_object_t() {}
 
-    return env->CallBooleanMethodA(receiver, method, argv);
+  java_class_loader_t(JNIEnv *env, jobject handle) : java_object_t(env, handle) {}
+
+  java_class_loader_t(java_class_loader_t &&that) {
+    swap(that);
   }
 
-  static bool
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  java_class_loader_t(const java_class_loader_t &that) : java_object_t(that) {}
+
+  java_class_loader_t &
+  operator=(java_class_loader_t that) {
+    swap(that);
 
-    return env->CallStaticBooleanMethodA(receiver, method, argv);
+    return *this;
   }
-};
 
-template <typename... A>
-struct java_method_invoker_t<unsigned char(A...)> {
-  static unsigned char
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  template <java_class_name_t N, typename T = java_object_t<N>>
+  auto
+  load_class(const char *class_name) {
+    auto load_class = get_class().get_method<java_class_t<N, T>(const char *)>("loadClass");
 
-    return env->CallByteMethodA(receiver, method, argv);
+    return java_class_t<N, T>(env_, load_class(*this, class_name));
   }
 
-  static unsigned char
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  template <java_class_name_t N, typename T = java_object_t<N>>
+  auto
+  load_class(const std::string &class_name) {
+    return load_class<N, T>(class_name.c_str());
+  }
+
+  template <java_class_name_t N, typename T = java_object_t<N>>
+  auto
+  load_class() {
+    auto class_name = std::string(N);
+
+    for (auto &c : class_name) {
+      if (c == '/') c = '.';
+    }
 
-    return env->CallStaticByteMethodA(receiver, method, argv);
+    return load_class<N, T>(class_name);
   }
 };
 
-template <typename... A>
-struct java_method_invoker_t<char(A...)> {
-  static char
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+struct java_natives_registry_t {
+  using register_t = void (*)(JNIEnv *, jclass);
+
+  static java_natives_registry_t &
+  get() {
+    static java_natives_registry_t registry;
 
-    return env->CallCharMethodA(receiver, method, argv);
+    return registry;
   }
 
-  static char
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  void
+  add(const char *class_name, register_t fn) {
+    std::scoped_lock lock(mutex_);
 
-    return env->CallStaticCharMethodA(receiver, method, argv);
+    classes_[class_name].push_back(fn);
   }
-};
 
-template <typename... A>
-struct java_method_invoker_t<short(A...)> {
-  static short
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  void
+  register_natives(JNIEnv *env) {
+    std::scoped_lock lock(mutex_);
 
-    return env->CallShortMethodA(receiver, method, argv);
+    for (auto &[class_name, natives] : classes_) {
+      register_natives(env, class_name, natives);
+    }
   }
 
-  static char
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  void
+  register_natives(JNIEnv *env, const std::string &class_name) {
+    std::scoped_lock lock(mutex_);
+
+    auto it = classes_.find(class_name);
 
-    return env->CallStaticShortMethodA(receiver, method, argv);
+    if (it == classes_.end()) return;
+
+    register_natives(env, class_name, it->second);
   }
-};
 
-template <typename... A>
-struct java_method_invoker_t<int(A...)> {
-  static int
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  void
+  register_natives(JNIEnv *env, java_class_loader_t class_loader) {
+    std::scoped_lock lock(mutex_);
+
+    for (auto &[class_name, natives] : classes_) {
+      auto binary_name = class_name;
+
+      for (auto &c : binary_name) {
+        if (c == '/') c = '.';
+      }
+
+      auto clazz = class_loader.load_class<"java/lang/Object">(binary_name);
 
-    return env->CallIntMethodA(receiver, method, argv);
+      if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+
+        throw std::invalid_argument("Could not load class with name '" + class_name + "'");
+      }
+
+      for (auto &fn : natives) fn(env, clazz);
+
+      env->DeleteLocalRef(clazz);
+    }
   }
 
-  static int
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  jint
+  on_load(JavaVM *vm) {
+    JNIEnv *env;
+
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) return JNI_ERR;
+
+    try {
+      register_natives(env);
+    } catch (...) {
+      return JNI_ERR;
+    }
 
-    return env->CallStaticIntMethodA(receiver, method, argv);
+    return JNI_VERSION_1_6;
   }
-};
 
-template <typename... A>
-struct java_method_invoker_t<long(A...)> {
-  static long
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+private:
+  void
+  register_natives(JNIEnv *env, const std::string &class_name, const std::vector<register_t> &natives) {
+    auto clazz = env->FindClass(class_name.c_str());
+
+    if (clazz == nullptr) {
+      env->ExceptionClear();
 
-    return env->CallLongMethodA(receiver, method, argv);
+      throw std::invalid_argument("Could not find class with name '" + class_name + "'");
+    }
+
+    for (auto &fn : natives) fn(env, clazz);
+
+    env->DeleteLocalRef(clazz);
   }
 
-  static long
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  std::map<std::string, std::vector<register_t>> classes_;
+  std::mutex mutex_;
+};
 
-    return env->CallStaticLongMethodA(receiver, method, argv);
+template <java_class_name_t N, java_native_method... M>
+struct java_natives_t {
+  java_natives_t() {
+    java_natives_registry_t::get().add(N, [](JNIEnv *env, jclass clazz) {
+      java_class_t<N>(env, clazz).template register_natives<M...>();
+    });
   }
 };
 
-template <typename... A>
-struct java_method_invoker_t<float(A...)> {
-  static float
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+#define JNITL_CONCAT_(a, b) a##b
+#define JNITL_CONCAT(a, b)  JNITL_CONCAT_(a, b)
 
-    return env->CallFloatMethodA(receiver, method, argv);
+#define JNITL_NATIVES(class_name, ...) \
+  [[maybe_unused]] static const java_natives_t<class_name, __VA_ARGS__> JNITL_CONCAT(jnitl_natives_, __COUNTER__);
+
+#define JNITL_ONLOAD() \
+  extern "C" JNIEXPORT jint JNICALL \
+  JNI_OnLoad(JavaVM *vm, void *reserved) { \
+    return java_natives_registry_t::get().on_load(vm); \
   }
 
-  static float
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+struct java_thread_t : java_object_t<"java/lang/Thread"> {
+  java_thread_t() : java_object_t() {}
+
+  java_thread_t(JNIEnv *env, jobject handle) : java_object_t(env, handle) {}
+
+  java_thread_t(java_thread_t &&that) {
+    swap(that);
+  }
+
+  java_thread_t(const java_thread_t &that) : java_object_t(that) {}
+
+  java_thread_t &
+  operator=(java_thread_t that) {
+    swap(that);
+
+    return *this;
+  }
+
+  auto
+  get_context_class_loader() {
+    auto get_context_class_loader = get_class().get_method<java_object_t<"java/lang/ClassLoader">()>("getContextClassLoader");
+
+    return java_class_loader_t(env_, get_context_class_loader(*this));
+  }
+
+  static auto
+  current_thread(JNIEnv *env) {
+    auto current_thread = get_class(env).get_static_method<java_object_t<"java/lang/Thread">()>("currentThread");
 
-    return env->CallStaticFloatMethodA(receiver, method, argv);
+    return java_thread_t(env, current_thread());
   }
 };
 
-template <typename... A>
-struct java_method_invoker_t<double(A...)> {
-  static double
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+struct java_native_peer_info_t {
+  jclass class_;
+  jmethodID register_;
+  jmethodID install_;
+  jmethodID uninstall_;
+  jmethodID clean_;
+
+  static const java_native_peer_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_native_peer_info_t info;
+
+      auto native_peer = env->FindClass("to/holepunch/jnitl/NativePeer");
+
+      if (native_peer == nullptr) {
+        env->ExceptionClear();
+
+        throw std::invalid_argument("Could not find class with name 'to/holepunch/jnitl/NativePeer'");
+      }
+
+      info.class_ = reinterpret_cast<jclass>(env->NewGlobalRef(native_peer));
+      info.register_ = env->GetStaticMethodID(native_peer, "register", "(Ljava/lang/Object;JJ)Ljava/lang/ref/Cleaner$Cleanable;");
+      info.install_ = env->GetStaticMethodID(native_peer, "install", "(Ljava/nio/ByteBuffer;)V");
+      info.uninstall_ = env->GetStaticMethodID(native_peer, "uninstall", "()V");
+
+      auto cleanable = env->FindClass("java/lang/ref/Cleaner$Cleanable");
+
+      info.clean_ = env->GetMethodID(cleanable, "clean", "()V");
+
+      JNINativeMethod methods[] = {
+        {
+          .name = const_cast<char *>("destroy"),
+          .signature = const_cast<char *>("(JJ)V"),
+          .fnPtr = reinterpret_cast<void *>(+[](JNIEnv *env, jclass, jlong finalizer, jlong peer) {
+            java_epoch_t::retire(reinterpret_cast<void (*)(void *)>(finalizer), reinterpret_cast<void *>(peer));
+          }),
+        },
+      };
+
+      env->RegisterNatives(native_peer, methods, 1);
+
+      env->DeleteLocalRef(cleanable);
+      env->DeleteLocalRef(native_peer);
+
+      return info;
+    }(env);
+
+    return info;
+  }
+};
+
+struct java_function_slab_t {
+  using function_t = std::function<jobject(JNIEnv *, jobject)>;
+
+  static constexpr size_t block_size = 256;
+  static constexpr size_t max_blocks = 4096;
+
+  static java_function_slab_t &
+  get() {
+    static java_function_slab_t slab;
+
+    return slab;
+  }
+
+  java_function_slab_t() : blocks_(), next_(0) {}
+
+  java_function_slab_t(const java_function_slab_t &) = delete;
+
+  ~java_function_slab_t() {
+    for (auto &block : blocks_) delete block.load(std::memory_order_relaxed);
+  }
+
+  java_function_slab_t &
+  operator=(const java_function_slab_t &) = delete;
+
+  size_t
+  allocate(function_t fn) {
+    std::scoped_lock lock(mutex_);
+
+    size_t slot;
+
+    if (free_.empty()) {
+      if (next_ == block_size * max_blocks) throw std::length_error("Function slab exhausted");
+
+      slot = next_++;
+
+      auto &block = blocks_[slot / block_size];
+
+      if (slot % block_size == 0) block.store(new block_t(), std::memory_order_release);
+    } else {
+      slot = free_.back();
+
+      free_.pop_back();
+    }
+
+    at(slot) = std::move(fn);
 
-    return env->CallDoubleMethodA(receiver, method, argv);
+    return slot;
   }
 
-  static double
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  void
+  release(size_t slot) {
+    function_t fn;
 
-    return env->CallStaticDoubleMethodA(receiver, method, argv);
-  }
-};
+    std::scoped_lock lock(mutex_);
 
-template <typename R, typename... A>
-struct java_method_invoker_t<R(A...)> {
-  static R
-  call(JNIEnv *env, jobject receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+    std::swap(fn, at(slot));
 
-    return java_unmarshall_value<R>(env, env->CallObjectMethodA(receiver, method, argv));
+    free_.push_back(slot);
   }
 
-  static R
-  call(JNIEnv *env, jclass receiver, jmethodID method, A... args) {
-    jvalue argv[] = {
-      java_marshall_argument_value(env, std::move(args))...
-    };
+  function_t &
+  at(size_t slot) const {
+    return blocks_[slot / block_size].load(std::memory_order_acquire)->slots_[slot % block_size];
+  }
 
-    return java_unmarshall_value<R>(env, env->CallStaticObjectMethodA(receiver, method, argv));
+  static void
+  finalize(void *slot) {
+    get().release(reinterpret_cast<uintptr_t>(slot));
   }
+
+private:
+  struct block_t {
+    std::array<function_t, block_size> slots_;
+  };
+
+  std::array<std::atomic<block_t *>, max_blocks> blocks_;
+  std::vector<size_t> free_;
+  size_t next_;
+  std::mutex mutex_;
 };
 
-struct java_method_base_t {
-  java_method_base_t() : env_(nullptr), class_(nullptr), id_(nullptr) {}
+struct java_native_function_info_t {
+  jclass class_;
+  jmethodID constructor_;
 
-  java_method_base_t(JNIEnv *env, jclass clazz, jmethodID id) : env_(env), class_(clazz), id_(id) {}
+  static const java_native_function_info_t &
+  get(JNIEnv *env) {
+    static const auto info = [](JNIEnv *env) {
+      java_native_function_info_t info;
 
-  java_method_base_t(java_method_base_t &&) = default;
+      java_native_peer_info_t::get(env);
 
-  java_method_base_t(const java_method_base_t &) = delete;
+      java_exception_info_t::get(env);
 
-  java_method_base_t &
-  operator=(java_method_base_t &&) = default;
+      auto native_function = env->FindClass("to/holepunch/jnitl/NativeFunction");
 
-  java_method_base_t &
-  operator=(const java_method_base_t &) = delete;
+      if (native_function == nullptr) {
+        env->ExceptionClear();
 
-  operator jmethodID() const {
-    return id_;
-  }
+        throw std::invalid_argument("Could not find class with name 'to/holepunch/jnitl/NativeFunction'");
+      }
 
-protected:
-  JNIEnv *env_;
-  jclass class_;
-  jmethodID id_;
-};
+      info.class_ = reinterpret_cast<jclass>(env->NewGlobalRef(native_function));
+      info.constructor_ = env->GetMethodID(native_function, "<init>", "(JJ)V");
 
-template <java_class_name_t, typename>
-struct java_method_t;
+      JNINativeMethod methods[] = {
+        {
+          .name = const_cast<char *>("invoke"),
+          .signature = const_cast<char *>("(JLjava/lang/Object;)Ljava/lang/Object;"),
+          .fnPtr = reinterpret_cast<void *>(+[](JNIEnv *env, jclass, jlong slot, jobject argument) noexcept -> jobject {
+            try {
+              return java_function_slab_t::get().at(static_cast<size_t>(slot))(env, argument);
+            } catch (...) {
+              java_throw_current_exception(env);
 
-template <java_class_name_t N, typename... A>
-struct java_method_t<N, void(A...)> : java_method_base_t {
-  void call(const java_object_t<N> &receiver, A... args) const {
-    java_method_invoker_t<void(A...)>::call(env_, receiver, id_, std::move(args)...);
-  }
+              return nullptr;
+            }
+          }),
+        },
+      };
 
-  void operator()(const java_object_t<N> &receiver, A... args) const {
-    call(receiver, std::move(args)...);
-  }
-};
+      if (env->RegisterNatives(native_function, methods, 1) != JNI_OK) {
+        env->ExceptionClear();
+
+        throw std::invalid_argument("Could not register natives for class with name 'to/holepunch/jnitl/NativeFunction'");
+      }
+
+      env->DeleteLocalRef(native_function);
+
+      return info;
+    }(env);
 
-template <java_class_name_t N, typename R, typename... A>
-struct java_method_t<N, R(A...)> : java_method_base_t {
-  R call(const java_object_t<N> &receiver, A... args) const {
-    return java_method_invoker_t<R(A...)>::call(env_, receiver, id_, std::move(args)...);
+    return info;
   }
 
-  R operator()(const java_object_t<N> &receiver, A... args) const {
-    return call(receiver, std::move(args)...);
+  template <java_class_name_t N>
+  java_object_t<N>
+  create(JNIEnv *env, java_function_slab_t::function_t fn) const {
+    auto &slab = java_function_slab_t::get();
+
+    auto slot = slab.allocate(std::move(fn));
+
+    auto object = env->NewObject(class_, constructor_, static_cast<jlong>(slot), reinterpret_cast<jlong>(&java_function_slab_t::finalize));
+
+    if (object == nullptr) slab.release(slot);
+
+    return java_object_t<N>(env, object);
   }
 };
 
-template <java_class_name_t N>
-template <typename... A>
-void
-java_object_t<N>::apply(const java_method_t<N, void(A...)> &method, A... args) const {
-  method(*this, std::move(args)...);
+template <typename F>
+static auto
+java_runnable(JNIEnv *env, F fn) {
+  return java_native_function_info_t::get(env).create<"java/lang/Runnable">(env, [fn = std::move(fn)](JNIEnv *env, jobject) mutable -> jobject {
+    fn();
+
+    return nullptr;
+  });
 }
 
-template <java_class_name_t N>
-template <typename R, typename... A>
-R
-java_object_t<N>::apply(const java_method_t<N, R(A...)> &method, A... args) const {
-  return method(*this, std::move(args)...);
+template <typename T, typename F>
+static auto
+java_consumer(JNIEnv *env, F fn) {
+  return java_native_function_info_t::get(env).create<"java/util/function/Consumer">(env, [fn = std::move(fn)](JNIEnv *env, jobject argument) mutable -> jobject {
+    fn(java_unmarshall_element<T>(env, argument));
+
+    return nullptr;
+  });
 }
 
-template <typename T>
-struct java_static_method_t;
+template <typename R, typename T, typename F>
+static auto
+java_function(JNIEnv *env, F fn) {
+  return java_native_function_info_t::get(env).create<"java/util/function/Function">(env, [fn = std::move(fn)](JNIEnv *env, jobject argument) mutable -> jobject {
+    return java_marshall_element<R>(env, fn(java_unmarshall_element<T>(env, argument)));
+  });
+}
 
-template <typename... A>
-struct java_static_method_t<void(A...)> : java_method_base_t {
-  void call(A... args) const {
-    java_method_invoker_t<void(A...)>::call(env_, class_, id_, std::move(args)...);
-  }
+template <java_class_name_t N, typename T, java_class_name_t F = "peer", java_class_name_t C = "cleanable">
+struct java_peer_t {
+  static constexpr java_class_name_t name = N;
 
-  void operator()(A... args) const {
-    call(std::move(args)...);
+  static T &
+  get(JNIEnv *env, jobject receiver) {
+    return *reinterpret_cast<T *>(env->GetLongField(receiver, field(env)));
   }
-};
 
-template <typename R, typename... A>
-struct java_static_method_t<R(A...)> : java_method_base_t {
-  R call(A... args) const {
-    return java_method_invoker_t<R(A...)>::call(env_, class_, id_, std::move(args)...);
+  static T *
+  try_get(JNIEnv *env, jobject receiver) {
+    return reinterpret_cast<T *>(env->GetLongField(receiver, field(env)));
   }
 
-  R operator()(A... args) const {
-    return call(std::move(args)...);
-  }
-};
+  static void
+  attach(JNIEnv *env, jobject receiver, T *peer) {
+    auto &info = java_native_peer_info_t::get(env);
 
-template <auto fn>
-struct java_native_method_t {
-  java_native_method_t(const char *name) : name_(name) {}
+    env->SetLongField(receiver, field(env), reinterpret_cast<jlong>(peer));
 
-  java_native_method_t(const std::string &name) : name_(name) {}
+    auto cleanable = env->CallStaticObjectMethod(info.class_, info.register_, receiver, reinterpret_cast<jlong>(&finalize), reinterpret_cast<jlong>(peer));
 
-  java_native_method_t(java_native_method_t &&) = default;
+    env->SetObjectField(receiver, cleanable_field(env), cleanable);
 
-  java_native_method_t(const java_native_method_t &) = delete;
+    env->DeleteLocalRef(cleanable);
+  }
 
-  java_native_method_t &
-  operator=(java_native_method_t &&) = default;
+  template <typename U>
+  static decltype(auto)
+  apply(JNIEnv *env, jobject receiver, U &&fn) {
+    auto guard = java_epoch_t::enter();
 
-  java_native_method_t &
-  operator=(const java_native_method_t &) = delete;
+    auto self = try_get(env, receiver);
 
-private:
-  operator JNINativeMethod() const {
-    return {
-      .name = const_cast<char *>(name_.c_str()),
-      .signature = const_cast<char *>(java_callback_t<fn>::signature.c_str()),
-      .fnPtr = reinterpret_cast<void *>(java_callback_t<fn>::create()),
-    };
-  }
+    if (self == nullptr) throw std::logic_error("Native peer is closed");
 
-  template <java_class_name_t, typename>
-  friend struct java_class_t;
+    return fn(*self);
+  }
 
-private:
-  std::string name_;
-};
+  template <typename... A>
+  static T &
+  emplace(JNIEnv *env, jobject receiver, A &&...args) {
+    auto peer = new T(std::forward<A>(args)...);
 
-template <typename T>
-constexpr bool java_is_native_method = false;
+    attach(env, receiver, peer);
 
-template <auto fn>
-constexpr bool java_is_native_method<java_native_method_t<fn>> = true;
+    return *peer;
+  }
 
-template <typename T>
-concept java_native_method = java_is_native_method<T>;
+  static void
+  close(JNIEnv *env, jobject receiver) {
+    auto cleanable = env->GetObjectField(receiver, cleanable_field(env));
 
-template <java_class_name_t N, typename T = java_object_t<N>>
-struct java_class_t : java_object_t<"java/lang/Class"> {
-  java_class_t() : java_object_t() {}
+    env->SetLongField(receiver, field(env), 0);
 
-  java_class_t(JNIEnv *env, jobject clazz) : java_object_t(env, clazz) {}
+    if (cleanable == nullptr) return;
 
-  java_class_t(JNIEnv *env) : java_object_t(env, nullptr) {
-    handle_ = env_->FindClass(N);
+    env->SetObjectField(receiver, cleanable_field(env), nullptr);
 
-    if (handle_ == nullptr) {
-      env_->ExceptionClear();
+    env->CallVoidMethod(cleanable, java_native_peer_info_t::get(env).clean_);
 
-      throw std::invalid_argument("Could not find class with name '" + std::string(name) + "'");
-    }
+    env->DeleteLocalRef(cleanable);
   }
 
-  java_class_t(java_class_t &&that) {
-    swap(that);
-  }
+  static jfieldID
+  field(JNIEnv *env) {
+    static const auto id = resolve(env, F, "J");
 
-  java_class_t(const java_class_t &that) : java_object_t(that) {}
+    return id;
+  }
 
-  java_class_t &
-  operator=(java_class_t that) {
-    swap(that);
+  static jfieldID
+  cleanable_field(JNIEnv *env) {
+    static const auto id = resolve(env, C, "Ljava/lang/ref/Cleaner$Cleanable;");
 
-    return *this;
+    return id;
   }
 
-  operator jclass() const {
-    return handle_;
+private:
+  static void
+  finalize(void *peer) {
+    delete static_cast<T *>(peer);
   }
 
-  template <typename... A>
-  T operator()(A... args) const {
-    auto init = get_method<void(A...)>("<init>");
+  static jfieldID
+  resolve(JNIEnv *env, const char *name, const char *signature) {
+    auto clazz = env->FindClass(N);
 
-    jvalue argv[] = {
-      java_marshall_argument_value(env_, std::move(args))...
-    };
+    if (clazz == nullptr) {
+      env->ExceptionClear();
 
-    return T(env_, env_->NewObjectA(jclass(handle_), init, argv));
-  }
+      throw std::invalid_argument("Could not find class with name '" + std::string(N) + "'");
+    }
 
-  template <typename U>
-  auto
-  get_field(const char *name) const {
-    auto signature = java_type_info_t<U>::signature.c_str();
+    auto id = env->GetFieldID(clazz, name, signature);
 
-    auto id = env_->GetFieldID(jclass(handle_), name, signature);
+    env->DeleteLocalRef(clazz);
 
     if (id == nullptr) {
+      env->ExceptionClear();
+
       throw std::invalid_argument(
         "Could not find field '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
       );
     }
 
-    return java_field_t<N, U>(java_field_base_t(env_, jclass(handle_), id));
+    return id;
   }
+};
 
-  template <typename U>
-  auto
-  get_field(std::string name) const {
-    return get_field<U>(name.c_str());
-  }
+struct java_reclamation_queue_t {
+  java_reclamation_queue_t(JNIEnv *env, size_t capacity = 1 << 16, std::chrono::milliseconds interval = std::chrono::milliseconds(10))
+      : vm_(nullptr),
+        memory_(nullptr),
+        interval_(interval),
+        closing_(false) {
+    env->GetJavaVM(&vm_);
 
-  template <typename U>
-  auto
-  get_static_field(const char *name) const {
-    auto signature = java_type_info_t<U>::signature.c_str();
+    auto length = java_ring_buffer_t::length(capacity);
 
-    auto id = env_->GetStaticFieldID(jclass(handle_), name, signature);
+    memory_ = static_cast<uint8_t *>(::operator new(length, std::align_val_t(java_ring_buffer_t::cache_line)));
 
-    if (id == nullptr) {
-      throw std::invalid_argument(
-        "Could not find field '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
-      );
-    }
+    std::fill_n(memory_, length, 0);
 
-    return java_static_field_t<N, U>(java_field_base_t(env_, jclass(handle_), id));
-  }
+    try {
+      auto buffer = java_byte_buffer_t(env, memory_, length);
 
-  template <typename U>
-  auto
-  get_static_field(std::string name) const {
-    return get_static_field<U>(name.c_str());
-  }
+      ring_ = java_ring_buffer_t(buffer);
 
-  template <typename U>
-  auto
-  get_method(const char *name) const {
-    auto signature = java_type_info_t<U>::signature.c_str();
+      auto &info = java_native_peer_info_t::get(env);
 
-    auto id = env_->GetMethodID(jclass(handle_), name, signature);
+      env->CallStaticVoidMethod(info.class_, info.install_, static_cast<jobject>(buffer));
 
-    if (id == nullptr) {
-      throw std::invalid_argument(
-        "Could not find method '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
-      );
+      env->DeleteLocalRef(buffer);
+
+      if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+
+        throw std::invalid_argument("Could not install reclamation queue");
+      }
+    } catch (...) {
+      ::operator delete(memory_, std::align_val_t(java_ring_buffer_t::cache_line));
+
+      throw;
     }
 
-    return java_method_t<N, U>(java_method_base_t(env_, jclass(handle_), id));
+    thread_ = std::thread(&java_reclamation_queue_t::run, this);
   }
 
-  template <typename U>
-  auto
-  get_method(std::string name) const {
-    return get_method<U>(name.c_str());
-  }
+  java_reclamation_queue_t(const java_reclamation_queue_t &) = delete;
 
-  template <typename U>
-  auto
-  get_static_method(const char *name) const {
-    auto signature = java_type_info_t<U>::signature.c_str();
+  ~java_reclamation_queue_t() {
+    {
+      auto vm = java_vm_t(vm_);
 
-    auto id = env_->GetStaticMethodID(jclass(handle_), name, signature);
+      auto env = vm.get_env();
 
-    if (id == nullptr) {
-      throw std::invalid_argument(
-        "Could not find method '" + std::string(name) + "' with signature '" + std::string(signature) + "'"
-      );
+      if (env) uninstall(*env);
+      else uninstall(vm.attach_current_thread());
     }
 
-    return java_static_method_t<U>(java_method_base_t(env_, jclass(handle_), id));
-  }
+    {
+      std::lock_guard lock(mutex_);
 
-  template <typename U>
-  auto
-  get_static_method(std::string name) const {
-    return get_static_method<U>(name.c_str());
-  }
+      closing_ = true;
+    }
 
-  template <typename U>
-  U
-  get(const java_static_field_t<N, U> &field) const {
-    return java_field_accessor_t<U>::get(env_, jclass(handle_), field);
-  }
+    wake_.notify_one();
 
-  template <typename U>
-  void
-  set(const java_static_field_t<N, U> &field, const U &value) const {
-    java_field_accessor_t<U>::set(env_, jclass(handle_), field, value);
-  }
+    thread_.join();
 
-  template <typename... A>
-  void
-  apply(const java_static_method_t<void(A...)> &method, A... args) const {
-    method(*this, std::move(args)...);
-  }
+    reclaim();
 
-  template <typename R, typename... A>
-  R
-  apply(const java_static_method_t<R(A...)> &method, A... args) const {
-    return method(*this, std::move(args)...);
+    ::operator delete(memory_, std::align_val_t(java_ring_buffer_t::cache_line));
   }
 
-  template <java_native_method... M>
-  void
-  register_natives(M... methods) {
-    env_->RegisterNatives(jclass(handle_), (JNINativeMethod[]) {methods...}, sizeof...(M));
-  }
+  java_reclamation_queue_t &
+  operator=(const java_reclamation_queue_t &) = delete;
 
-  void
-  unregister_natives() {
-    env_->UnregisterNatives(jclass(handle_));
-  }
-};
+  size_t
+  reclaim() {
+    std::lock_guard lock(reclaim_);
 
-struct java_class_loader_t : java_object_t<"java/lang/ClassLoader"> {
-  java_class_loader_t() : java_object_t() {}
+    batch_.clear();
 
-  java_class_loader_t(JNIEnv *env, jobject handle) : java_object_t(env, handle) {}
+    ring_.read([this](int32_t type, std::span<const uint8_t> data) {
+      int64_t entry[2];
 
-  java_class_loader_t(java_class_loader_t &&that) {
-    swap(that);
-  }
+      std::memcpy(entry, data.data(), sizeof(entry));
 
-  java_class_loader_t(const java_class_loader_t &that) : java_object_t(that) {}
+      batch_.push_back({
+        reinterpret_cast<void (*)(void *)>(static_cast<intptr_t>(entry[0])),
+        reinterpret_cast<void *>(static_cast<intptr_t>(entry[1])),
+      });
+    });
 
-  java_class_loader_t &
-  operator=(java_class_loader_t that) {
-    swap(that);
+    if (batch_.empty()) return 0;
 
-    return *this;
-  }
+    java_epoch_t::synchronize();
 
-  template <java_class_name_t N, typename T = java_object_t<N>>
-  auto
-  load_class(const char *class_name) {
-    auto load_class = get_class().get_method<java_class_t<N, T>(const char *)>("loadClass");
+    for (auto &[finalizer, peer] : batch_) finalizer(peer);
 
-    return java_class_t<N, T>(env_, load_class(*this, class_name));
+    return batch_.size();
   }
 
-  template <java_class_name_t N, typename T = java_object_t<N>>
-  auto
-  load_class(const std::string &class_name) {
-    return load_class<N, T>(class_name.c_str());
+private:
+  void
+  uninstall(JNIEnv *env) {
+    auto &info = java_native_peer_info_t::get(env);
+
+    env->CallStaticVoidMethod(info.class_, info.uninstall_);
   }
 
-  template <java_class_name_t N, typename T = java_object_t<N>>
-  auto
-  load_class() {
-    auto class_name = std::string(N);
+  void
+  run() {
+    auto env = java_vm_t(vm_).attach_current_thread();
 
-    for (auto &c : class_name) {
-      if (c == '/') c = '.';
-    }
+    std::unique_lock lock(mutex_);
 
-    return load_class<N, T>(class_name);
-  }
-};
+    while (!closing_) {
+      wake_.wait_for(lock, interval_);
 
-struct java_thread_t : java_object_t<"java/lang/Thread"> {
-  java_thread_t() : java_object_t() {}
+      lock.unlock();
 
-  java_thread_t(JNIEnv *env, jobject handle) : java_object_t(env, handle) {}
+      reclaim();
 
-  java_thread_t(java_thread_t &&that) {
-    swap(that);
+      lock.lock();
+    }
   }
 
-  java_thread_t(const java_thread_t &that) : java_object_t(that) {}
+  JavaVM *vm_;
+  uint8_t *memory_;
+  java_ring_buffer_t ring_;
+  std::chrono::milliseconds interval_;
+  std::vector<std::pair<void (*)(void *), void *>> batch_;
+  std::mutex reclaim_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool closing_;
+  std::thread thread_;
+};
 
-  java_thread_t &
-  operator=(java_thread_t that) {
-    swap(that);
+template <java_peer_type T>
+struct java_type_info_t<T &> {
+  using type = jobject;
 
-    return *this;
-  }
+  using peer = typename java_peer_type_t<T>::type;
 
-  auto
-  get_context_class_loader() {
-    auto get_context_class_loader = get_class().get_method<java_object_t<"java/lang/ClassLoader">()>("getContextClassLoader");
+  static constexpr java_string_literal_t signature = "L" + peer::name + ";";
 
-    return java_class_loader_t(env_, get_context_class_loader(*this));
-  }
+  static T &
+  unmarshall(JNIEnv *env, jobject value) {
+    auto self = peer::try_get(env, value);
 
-  static auto
-  current_thread(JNIEnv *env) {
-    auto current_thread = get_class(env).get_static_method<java_object_t<"java/lang/Thread">()>("currentThread");
+    if (self == nullptr) throw std::logic_error("Native peer is closed");
 
-    return java_thread_t(env, current_thread());
+    return *self;
   }
 };
@@ -0,0 +1,58 @@
+package to.holepunch.jnitl;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+
+final class Containers {
+  private Containers() {}
+
+  static List<Object> list(Object[] elements) {
+    return new ArrayList<>(Arrays.asList(elements));
+  }
+
+  static Set<Object> set(Object[] elements) {
+    return new HashSet<>(Arrays.asList(elements));
+  }
+
+  static Map<Object, Object> map(Object[] entries) {
+    Map<Object, Object> map = new HashMap<>((int) (entries.length / 2 / 0.75f) + 1);
+
+    for (int i = 0; i + 1 < entries.length; i += 2) {
+      map.put(entries[i], entries[i + 1]);
+    }
+
+    return map;
+  }
+
+  static int fill(Iterator<?> iterator, Object[] batch) {
+    int n = 0;
+
+    while (n < batch.length && iterator.hasNext()) {
+      batch[n++] = iterator.next();
+    }
+
+    if (n < batch.length) Arrays.fill(batch, n, batch.length, null);
+
+    return n;
+  }
+
+  static Object[] entries(Map<?, ?> map) {
+    Object[] entries = map.entrySet().toArray();
+    Object[] result = new Object[entries.length * 2];
+
+    for (int i = 0; i < entries.length; i++) {
+      Map.Entry<?, ?> entry = (Map.Entry<?, ?>) entries[i];
+
+      result[i * 2] = entry.getKey();
+      result[i * 2 + 1] = entry.getValue();
+    }
+
+    return result;
+  }
+}
@@ -0,0 +1,40 @@
+package to.holepunch.jnitl;
+
+import java.lang.ref.Reference;
+import java.util.function.Consumer;
+import java.util.function.Function;
+
+public final class NativeFunction implements Runnable, Consumer<Object>, Function<Object, Object> {
+  private final long slot;
+
+  private NativeFunction(long slot, long finalizer) {
+    this.slot = slot;
+
+    NativePeer.register(this, finalizer, slot);
+  }
+
+  @Override
+  public void run() {
+    call(null);
+  }
+
+  @Override
+  public void accept(Object argument) {
+    call(argument);
+  }
+
+  @Override
+  public Object apply(Object argument) {
+    return call(argument);
+  }
+
+  private Object call(Object argument) {
+    try {
+      return invoke(slot, argument);
+    } finally {
+      Reference.reachabilityFence(this);
+    }
+  }
+
+  private static native Object invoke(long slot, Object argument);
+}
@@ -0,0 +1,70 @@
+package to.holepunch.jnitl;
+
+import java.lang.ref.Cleaner;
+import java.nio.ByteBuffer;
+import java.util.concurrent.atomic.AtomicInteger;
+import java.util.concurrent.atomic.AtomicReference;
+
+public final class NativePeer implements Runnable {
+  private static final Cleaner cleaner = Cleaner.create();
+
+  private static final AtomicReference<RingBuffer> queue = new AtomicReference<>();
+
+  private static final AtomicInteger producers = new AtomicInteger();
+
+  private final long finalizer;
+  private final long peer;
+
+  private NativePeer(long finalizer, long peer) {
+    this.finalizer = finalizer;
+    this.peer = peer;
+  }
+
+  public static Cleaner.Cleanable register(Object owner, long finalizer, long peer) {
+    return cleaner.register(owner, new NativePeer(finalizer, peer));
+  }
+
+  static void install(ByteBuffer buffer) {
+    if (!queue.compareAndSet(null, new RingBuffer(buffer))) {
+      throw new IllegalStateException("Reclamation queue already installed");
+    }
+  }
+
+  static void uninstall() {
+    queue.set(null);
+
+    while (producers.get() != 0) {
+      Thread.onSpinWait();
+    }
+  }
+
+  @Override
+  public void run() {
+    producers.incrementAndGet();
+
+    try {
+      RingBuffer ring = queue.get();
+
+      if (ring != null) {
+        int offset = ring.claim(16);
+
+        if (offset != -1) {
+          ByteBuffer buffer = ring.buffer();
+
+          buffer.putLong(offset + RingBuffer.RECORD_HEADER_SIZE, finalizer);
+          buffer.putLong(offset + RingBuffer.RECORD_HEADER_SIZE + 8, peer);
+
+          ring.commit(offset, 0, 16);
+
+          return;
+        }
+      }
+    } finally {
+      producers.decrementAndGet();
+    }
+
+    destroy(finalizer, peer);
+  }
+
+  private static native void destroy(long finalizer, long peer);
+}
@@ -0,0 +1,140 @@
+package to.holepunch.jnitl;
+
+import java.lang.invoke.MethodHandles;
+import java.lang.invoke.VarHandle;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+public final class RingBuffer {
+  public static final int CACHE_LINE = 64;
+
+  public static final int TAIL_OFFSET = 0;
+  public static final int HEAD_OFFSET = 2 * CACHE_LINE;
+  public static final int HEADER_SIZE = 4 * CACHE_LINE;
+
+  public static final int RECORD_HEADER_SIZE = 8;
+  public static final int RECORD_ALIGNMENT = 8;
+
+  public static final int PADDING_TYPE = -1;
+
+  private static final VarHandle INT = MethodHandles.byteBufferViewVarHandle(int[].class, ByteOrder.nativeOrder());
+  private static final VarHandle LONG = MethodHandles.byteBufferViewVarHandle(long[].class, ByteOrder.nativeOrder());
+
+  public interface Handler {
+    void onRecord(int type, ByteBuffer buffer, int offset, int length);
+  }
+
+  private final ByteBuffer buffer;
+  private final int capacity;
+
+  public RingBuffer(ByteBuffer buffer) {
+    if (!buffer.isDirect()) throw new IllegalArgumentException("Ring buffer requires a direct byte buffer");
+
+    int capacity = buffer.capacity() - HEADER_SIZE;
+
+    if (capacity < RECORD_ALIGNMENT || Integer.bitCount(capacity) != 1) {
+      throw new IllegalArgumentException("Ring buffer capacity must be a power of two");
+    }
+
+    this.buffer = buffer.duplicate().order(ByteOrder.nativeOrder());
+    this.capacity = capacity;
+  }
+
+  public static RingBuffer allocate(int capacity) {
+    return new RingBuffer(ByteBuffer.allocateDirect(HEADER_SIZE + capacity));
+  }
+
+  public ByteBuffer buffer() {
+    return buffer;
+  }
+
+  public int capacity() {
+    return capacity;
+  }
+
+  public int claim(int length) {
+    int required = align(RECORD_HEADER_SIZE + length);
+
+    if (length < 0 || required > capacity / 8) throw new IllegalArgumentException("Record exceeds maximum length");
+
+    long tail, head = (long) LONG.getAcquire(buffer, HEAD_OFFSET);
+    int index, padding;
+
+    do {
+      tail = (long) LONG.getAcquire(buffer, TAIL_OFFSET);
+
+      if (required > capacity - (tail - head)) {
+        head = (long) LONG.getAcquire(buffer, HEAD_OFFSET);
+
+        if (required > capacity - (tail - head)) return -1;
+      }
+
+      index = (int) (tail & (capacity - 1));
+      padding = 0;
+
+      if (required > capacity - index) {
+        padding = capacity - index;
+
+        if (required + padding > capacity - (tail - head)) return -1;
+      }
+    } while (!LONG.compareAndSet(buffer, TAIL_OFFSET, tail, tail + padding + required));
+
+    if (padding != 0) {
+      INT.set(buffer, HEADER_SIZE + index + 4, PADDING_TYPE);
+      INT.setRelease(buffer, HEADER_SIZE + index, padding);
+
+      index = 0;
+    }
+
+    return HEADER_SIZE + index;
+  }
+
+  public void commit(int offset, int type, int length) {
+    if (type < 0) throw new IllegalArgumentException("Record type must be non-negative");
+
+    INT.set(buffer, offset + 4, type);
+    INT.setRelease(buffer, offset, RECORD_HEADER_SIZE + length);
+  }
+
+  public int read(Handler handler) {
+    return read(handler, Integer.MAX_VALUE);
+  }
+
+  public int read(Handler handler, int limit) {
+    long head = (long) LONG.get(buffer, HEAD_OFFSET);
+
+    int read = 0, consumed = 0;
+
+    while (read < limit && consumed < capacity) {
+      int index = (int) ((head + consumed) & (capacity - 1));
+      int offset = HEADER_SIZE + index;
+
+      int length = (int) INT.getAcquire(buffer, offset);
+
+      if (length == 0) break;
+
+      int type = (int) INT.get(buffer, offset + 4);
+      int required = align(length);
+
+      if (type != PADDING_TYPE) {
+        handler.onRecord(type, buffer, offset + RECORD_HEADER_SIZE, length - RECORD_HEADER_SIZE);
+
+        read++;
+      }
+
+      for (int i = 0; i < required; i += 8) {
+        LONG.set(buffer, offset + i, 0L);
+      }
+
+      consumed += required;
+    }
+
+    if (consumed != 0) LONG.setRelease(buffer, HEAD_OFFSET, head + consumed);
+
+    return read;
+  }
+
+  private static int align(int length) {
+    return (length + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+  }
+}
@@ -0,0 +1,69 @@
+#include <assert.h>
+#include <jnitl.h>
+
+auto
+length(java_env_t env, java_object_t<"java/lang/String"> receiver, java_arena_string_t argument, java_arena_span_t<int> values) {
+  assert(argument == "hello");
+  assert(argument.c_str()[argument.size()] == '\0');
+
+  auto total = static_cast<int>(argument.size());
+
+  for (auto value : values) total += value;
+
+  return total;
+}
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto &arena = java_arena_t::get();
+
+  auto before = arena.mark();
+
+  auto trampoline = java_callback_t<length>::create();
+
+  auto values = java_array_t<int>(env, 3);
+
+  values.copy_from(std::vector<int>{1, 2, 3});
+
+  assert(trampoline(env, nullptr, java_string_t(env, "hello"), values) == 11);
+
+  auto after = arena.mark();
+
+  assert(before.block_ == after.block_ && before.offset_ == after.offset_);
+
+  auto greeting = java_marshall_value<java_arena_string_t>(env, java_arena_string_t("hello"));
+
+  after = arena.mark();
+
+  assert(before.block_ == after.block_ && before.offset_ == after.offset_);
+
+  assert(!arena.scoped());
+
+  bool thrown = false;
+
+  try {
+    java_unmarshall_value<java_arena_string_t>(env, greeting);
+  } catch (const std::logic_error &) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  {
+    java_arena_scope_t scope;
+
+    assert(arena.scoped());
+
+    assert(java_unmarshall_value<java_arena_string_t>(env, greeting) == "hello");
+  }
+
+  assert(!arena.scoped());
+
+  auto large = arena.allocate<uint8_t>(java_arena_t::block_size * 2);
+
+  assert(large.size() == java_arena_t::block_size * 2);
+
+  arena.reset();
+}
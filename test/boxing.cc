@@ -0,0 +1,29 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto integer_class = java_class_t<"java/lang/Integer">(env);
+
+  auto value_of = integer_class.get_static_method<std::optional<int>(std::string)>("valueOf");
+
+  assert(value_of("42") == 42);
+
+  auto get_integer = integer_class.get_static_method<std::optional<int>(std::string)>("getInteger");
+
+  assert(get_integer("jnitl.missing") == std::nullopt);
+
+  auto equals = integer_class.get_method<bool(java_object_t<"java/lang/Object">)>("equals");
+
+  auto boxed = java_object_t<"java/lang/Integer">(env, java_marshall_value(env, std::optional<int>(1000)));
+
+  assert(equals(boxed, java_object_t<"java/lang/Object">(env, java_marshall_value(env, std::optional<int>(1000)))));
+
+  assert(static_cast<JNIEnv *>(env)->IsSameObject(java_marshall_value(env, std::optional<int>(7)), java_marshall_value(env, std::optional<int>(7))));
+
+  auto parse = java_class_t<"java/lang/Double">(env).get_static_method<std::optional<double>(std::string)>("valueOf");
+
+  assert(parse("1.5") == 1.5);
+}
@@ -0,0 +1,87 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto byte_buffer_class = java_class_t<"java/nio/ByteBuffer">(env);
+
+  auto allocate_direct = byte_buffer_class.get_static_method<java_object_t<"java/nio/ByteBuffer">(int)>("allocateDirect");
+
+  auto buffer = java_byte_buffer_t(env, allocate_direct(16));
+
+  assert(buffer.order() == std::endian::big);
+
+  int values[] = {1, 2, 3, 4};
+
+  buffer.copy_from(std::span(values));
+
+  assert(buffer[3] == 1);
+  assert(buffer[15] == 4);
+
+  auto result = buffer.slice<int>(0, 4);
+
+  assert(result[0] == 1);
+  assert(result[3] == 4);
+
+  int8_t signed_values[] = {-1, 2};
+
+  buffer.copy_from(std::span<const int8_t>(signed_values), 0, std::endian::big);
+
+  int8_t signed_bytes[2];
+
+  buffer.copy_to(std::span<int8_t>(signed_bytes), 0, std::endian::big);
+
+  assert(signed_bytes[0] == -1);
+  assert(signed_bytes[1] == 2);
+
+  auto allocate = byte_buffer_class.get_static_method<java_object_t<"java/nio/ByteBuffer">(int)>("allocate");
+
+  auto heap = java_byte_buffer_t(env, allocate(16));
+
+  assert(!heap.is_direct());
+  assert(heap.size() == 16);
+
+  heap.copy_from(std::span(values));
+
+  assert(heap.slice(0, 4)[3] == 1);
+  assert(heap.slice<int>(0, 4)[3] == 4);
+
+  auto wrap = byte_buffer_class.get_static_method<java_object_t<"java/nio/ByteBuffer">(java_array_t<unsigned char>, int, int)>("wrap");
+
+  auto slice = byte_buffer_class.get_method<java_object_t<"java/nio/ByteBuffer">()>("slice");
+
+  auto array = java_array_t<unsigned char>(env, 8);
+
+  auto wrapped = java_byte_buffer_t(env, wrap(array, 4, 2));
+
+  assert(wrapped.size() == 2);
+  assert(wrapped.begin() == wrapped.end());
+
+  bool thrown = false;
+
+  try {
+    wrapped[0];
+  } catch (const std::logic_error &) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  assert(java_byte_buffer_t(env, slice(wrap(array, 4, 2))).size() == 2);
+
+  uint8_t bytes[] = {1, 2};
+
+  wrapped.copy_from(std::span<const uint8_t>(bytes));
+
+  assert(array.slice()[4] == 1);
+  assert(array.slice()[5] == 2);
+
+  short shorts[] = {0x0102};
+
+  wrapped.copy_from(std::span(shorts), 0, std::endian::little);
+
+  assert(array.slice()[4] == 2);
+  assert(array.slice()[5] == 1);
+}
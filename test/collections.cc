@@ -0,0 +1,29 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  auto collections_class = java_class_t<"java/util/Collections">(env);
+
+  auto unmodifiable_list = collections_class.get_static_method<java_list_t<std::string>(java_list_t<std::string>)>("unmodifiableList");
+
+  auto list = unmodifiable_list(java_list_t<std::string>{"a", "b", "c"});
+
+  assert(list.size() == 3);
+  assert(list[2] == "c");
+
+  auto unmodifiable_set = collections_class.get_static_method<std::set<int>(std::set<int>)>("unmodifiableSet");
+
+  auto set = unmodifiable_set(std::set<int>{1, 2, 1000});
+
+  assert(set == std::set<int>({1, 2, 1000}));
+
+  auto unmodifiable_map = collections_class.get_static_method<std::unordered_map<std::string, long>(std::unordered_map<std::string, long>)>("unmodifiableMap");
+
+  auto map = unmodifiable_map(std::unordered_map<std::string, long>{{"one", 1}, {"two", 2}});
+
+  assert(map.size() == 2);
+  assert(map["two"] == 2);
+}
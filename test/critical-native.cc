@@ -0,0 +1,58 @@
+#include <assert.h>
+#include <jnitl.h>
+
+long
+multiply(long a, long b) noexcept {
+  return a * b;
+}
+
+int
+answer() noexcept {
+  return 42;
+}
+
+long
+divide(long a, long b) {
+  if (b == 0) throw std::overflow_error("Division by zero");
+
+  return a / b;
+}
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  auto natives_class = java_class_t<"to/holepunch/jnitl/test/Natives">(env);
+
+  natives_class.register_natives<
+    java_native_method_t<multiply, "multiply">,
+    java_native_method_t<answer, "answer">,
+    java_native_method_t<divide, "divide">>();
+
+  auto invoke_multiply = natives_class.get_static_method<long(long, long)>("multiply");
+
+  auto invoke_answer = natives_class.get_static_method<int()>("answer");
+
+  assert(invoke_multiply(3, 4) == 12);
+  assert(invoke_answer() == 42);
+
+  auto invoke_divide = natives_class.get_static_method<long(long, long), java_checked_t>("divide");
+
+  assert(invoke_divide(12, 4) == 3);
+
+  try {
+    invoke_divide(1, 0);
+
+    assert(false);
+  } catch (const java_exception_t &err) {
+    assert(err.class_name() == "java.lang.ArithmeticException");
+    assert(err.message() == "Division by zero");
+  }
+
+  natives_class.register_natives<
+    java_critical_native_method_t<multiply, "multiply">,
+    java_critical_native_method_t<answer, "answer">>();
+
+  assert(invoke_multiply(-5, 6) == -30);
+  assert(invoke_answer() == 42);
+}
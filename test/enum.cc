@@ -0,0 +1,82 @@
+#include <assert.h>
+#include <jnitl.h>
+
+enum class time_unit {
+  seconds,
+  milliseconds,
+  microseconds,
+};
+
+template <>
+struct java_enum_type_t<time_unit> {
+  using type = java_enum_t<"java/util/concurrent/TimeUnit", time_unit, "SECONDS", "MILLISECONDS", "MICROSECONDS">;
+};
+
+enum class thread_state {
+  terminated = -1,
+  runnable = 10,
+  blocked = 20,
+};
+
+template <>
+struct java_enum_type_t<thread_state> {
+  using type = java_enum_t<
+    "java/lang/Thread$State",
+    thread_state,
+    java_enum_constant_t(thread_state::blocked, "BLOCKED"),
+    java_enum_constant_t(thread_state::runnable, "RUNNABLE"),
+    java_enum_constant_t(thread_state::terminated, "TERMINATED")>;
+};
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto time_unit_class = java_class_t<"java/util/concurrent/TimeUnit">(env);
+
+  auto value_of = time_unit_class.get_static_method<time_unit(std::string)>("valueOf");
+
+  assert(value_of("SECONDS") == time_unit::seconds);
+  assert(value_of("MICROSECONDS") == time_unit::microseconds);
+
+  auto to_millis = time_unit_class.get_method<long(long)>("toMillis");
+
+  auto seconds = java_object_t<"java/util/concurrent/TimeUnit">(env, java_marshall_value(env, time_unit::seconds));
+
+  assert(to_millis(seconds, 2) == 2000);
+
+  auto nanoseconds = time_unit_class.get_static_field<java_object_t<"java/util/concurrent/TimeUnit">>("NANOSECONDS");
+
+  bool thrown = false;
+
+  try {
+    java_unmarshall_value<time_unit>(env, nanoseconds.get());
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  auto state_class = java_class_t<"java/lang/Thread$State">(env);
+
+  auto state_value_of = state_class.get_static_method<thread_state(std::string)>("valueOf");
+
+  assert(state_value_of("RUNNABLE") == thread_state::runnable);
+  assert(state_value_of("TERMINATED") == thread_state::terminated);
+
+  auto name = state_class.get_method<std::string()>("name");
+
+  auto blocked = java_object_t<"java/lang/Thread$State">(env, java_marshall_value(env, thread_state::blocked));
+
+  assert(name(blocked) == "BLOCKED");
+
+  thrown = false;
+
+  try {
+    java_marshall_value(env, static_cast<thread_state>(1));
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+
+  assert(thrown);
+}
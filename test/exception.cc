@@ -0,0 +1,33 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto integer_class = java_class_t<"java/lang/Integer">(env);
+
+  auto parse_int = integer_class.get_static_method<int(std::string), java_checked_t>("parseInt");
+
+  assert(parse_int("42") == 42);
+
+  try {
+    parse_int("nope");
+
+    assert(false);
+  } catch (const java_exception_t &err) {
+    assert(err.class_name() == "java.lang.NumberFormatException");
+    assert(!err.stack_trace().empty());
+  }
+
+  assert(!static_cast<JNIEnv *>(env)->ExceptionCheck());
+
+  auto try_parse_int = integer_class.get_static_method<int(std::string), java_expected_t>("parseInt");
+
+  auto result = try_parse_int("nope");
+
+  assert(!result);
+  assert(result.error().class_name() == "java.lang.NumberFormatException");
+
+  assert(*try_parse_int("42") == 42);
+}
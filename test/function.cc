@@ -0,0 +1,46 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  int calls = 0;
+
+  auto runnable = java_runnable(env, [&] { calls++; });
+
+  auto run = java_class_t<"java/lang/Runnable">(env).get_method<void()>("run");
+
+  run(runnable);
+  run(runnable);
+
+  assert(calls == 2);
+
+  std::string accepted;
+
+  auto consumer = java_consumer<std::string>(env, [&](std::string value) { accepted = value; });
+
+  auto accept = java_class_t<"java/util/function/Consumer">(env).get_method<void(java_object_t<"java/lang/Object">)>("accept");
+
+  accept(consumer, java_object_t<"java/lang/Object">(env, java_string_t(env, "hello")));
+
+  assert(accepted == "hello");
+
+  auto function = java_function<std::optional<int>, std::string>(env, [](std::string value) -> std::optional<int> {
+    if (value.empty()) throw std::invalid_argument("Empty string");
+
+    return static_cast<int>(value.size());
+  });
+
+  auto apply = java_class_t<"java/util/function/Function">(env).get_method<java_object_t<"java/lang/Object">(java_object_t<"java/lang/Object">)>("apply");
+
+  auto result = apply(function, java_object_t<"java/lang/Object">(env, java_string_t(env, "hello")));
+
+  assert(java_unmarshall_value<std::optional<int>>(env, result) == 5);
+
+  apply(function, java_object_t<"java/lang/Object">(env, java_string_t(env, "")));
+
+  assert(static_cast<JNIEnv *>(env)->ExceptionCheck());
+
+  static_cast<JNIEnv *>(env)->ExceptionClear();
+}
@@ -0,0 +1,28 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto map = java_identity_map_t<int>(env);
+
+  auto a = java_string_t(env, "hello");
+  auto b = java_string_t(env, "hello");
+
+  assert(map.insert(env, a, 1));
+  assert(map.insert(env, b, 2));
+  assert(!map.insert(env, a, 3));
+
+  assert(map.size() == 2);
+
+  assert(map.find(env, a) == 3);
+  assert(map.find(env, b) == 2);
+
+  assert(map.get_or_insert(env, b, [] { return 4; }) == 2);
+
+  assert(map.erase(env, a));
+  assert(!map.contains(env, a));
+
+  assert(map.size() == 1);
+}
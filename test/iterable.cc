@@ -0,0 +1,62 @@
+#include <assert.h>
+#include <jnitl.h>
+#include <vector>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  auto list = java_object_t<"java/lang/Iterable">(env, java_marshall_value(env, java_list_t<std::string>{"a", "bb", "ccc", "dddd", "eeeee"}));
+
+  auto length = java_class_t<"java/lang/String">(env).get_method<int()>("length");
+
+  int count = 0, total = 0;
+
+  for (auto string : java_iterable_t<"java/lang/String">(list, 2)) {
+    count++;
+    total += length(string);
+  }
+
+  assert(count == 5);
+  assert(total == 15);
+
+  auto empty = java_object_t<"java/lang/Iterable">(env, java_marshall_value(env, java_list_t<std::string>{}));
+
+  for (auto element : java_iterable_t(empty)) {
+    assert(false);
+  }
+
+  std::vector<java_object_t<"java/lang/String">> strings;
+
+  {
+    java_iterable_t<"java/lang/String"> iterable(list, 2);
+
+    for (auto string : iterable) strings.push_back(string);
+
+    total = 0;
+
+    for (auto &string : strings) total += length(string);
+
+    assert(strings.size() == 5);
+    assert(total == 15);
+  }
+
+  auto add = java_class_t<"java/util/List">(env).get_method<bool(java_object_t<"java/lang/Object">)>("add");
+
+  auto modified = java_object_t<"java/util/List">(env, java_marshall_value(env, java_list_t<std::string>{"a", "b", "c"}));
+
+  bool thrown = false;
+
+  try {
+    for (auto element : java_iterable_t(java_object_t<"java/lang/Iterable">(env, modified), 2)) {
+      add(modified, element);
+    }
+  } catch (const java_exception_t &err) {
+    assert(err.class_name() == "java.util.ConcurrentModificationException");
+
+    thrown = true;
+  }
+
+  assert(thrown);
+  assert(!static_cast<JNIEnv *>(env)->ExceptionCheck());
+}
@@ -0,0 +1,9 @@
+package to.holepunch.jnitl.test;
+
+public final class Constants {
+  public static int answer = 1;
+
+  public static Boolean flag = Boolean.FALSE;
+
+  private Constants() {}
+}
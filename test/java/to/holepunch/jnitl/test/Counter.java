@@ -0,0 +1,16 @@
+package to.holepunch.jnitl.test;
+
+import java.lang.ref.Cleaner;
+
+public final class Counter {
+  private long peer;
+  private Cleaner.Cleanable cleanable;
+
+  public native void increment();
+
+  public native long add(long amount);
+
+  public native long value();
+
+  public native long merge(Counter other);
+}
@@ -0,0 +1,23 @@
+package to.holepunch.jnitl.test;
+
+public final class Natives {
+  private final String name;
+
+  public Natives(String name) {
+    this.name = name;
+  }
+
+  public String name() {
+    return name;
+  }
+
+  public native int length(String suffix);
+
+  public static native int answer();
+
+  public static native long multiply(long a, long b);
+
+  public static native long divide(long a, long b);
+
+  public static native String greet(String name);
+}
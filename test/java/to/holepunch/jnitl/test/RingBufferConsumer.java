@@ -0,0 +1,26 @@
+package to.holepunch.jnitl.test;
+
+import java.nio.charset.StandardCharsets;
+import java.util.ArrayList;
+import java.util.List;
+import to.holepunch.jnitl.RingBuffer;
+
+public final class RingBufferConsumer {
+  private RingBufferConsumer() {}
+
+  public static List<String> drain(RingBuffer ring) {
+    List<String> records = new ArrayList<>();
+
+    ring.read((type, buffer, offset, length) -> {
+      byte[] bytes = new byte[length];
+
+      for (int i = 0; i < length; i++) {
+        bytes[i] = buffer.get(offset + i);
+      }
+
+      records.add(type + ":" + new String(bytes, StandardCharsets.UTF_8));
+    });
+
+    return records;
+  }
+}
@@ -0,0 +1,108 @@
+#include <assert.h>
+#include <jnitl.h>
+
+struct counter_t {
+  using java_peer = java_peer_t<"to/holepunch/jnitl/test/Counter", counter_t>;
+
+  long count = 0;
+
+  void
+  increment() noexcept {
+    count++;
+  }
+
+  long
+  add(long amount) {
+    if (amount < 0) throw std::out_of_range("Negative amount");
+
+    return count += amount;
+  }
+
+  long
+  value() const noexcept {
+    return count;
+  }
+
+  long
+  merge(const counter_t &other) noexcept {
+    return count += other.count;
+  }
+};
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  using peer = counter_t::java_peer;
+
+  auto counter_class = java_class_t<"to/holepunch/jnitl/test/Counter">(env);
+
+  counter_class.register_natives<
+    java_native_method_t<&counter_t::increment, "increment">,
+    java_native_method_t<&counter_t::add, "add">,
+    java_native_method_t<&counter_t::value, "value">,
+    java_native_method_t<&counter_t::merge, "merge">>();
+
+  auto invoke_increment = counter_class.get_method<void(), java_checked_t>("increment");
+  auto invoke_add = counter_class.get_method<long(long), java_checked_t>("add");
+  auto invoke_value = counter_class.get_method<long(), java_checked_t>("value");
+  auto invoke_merge = counter_class.get_method<long(java_object_t<"to/holepunch/jnitl/test/Counter">), java_checked_t>("merge");
+
+  auto counter = counter_class();
+
+  peer::emplace(env, counter);
+
+  invoke_increment(counter);
+
+  assert(invoke_add(counter, 41) == 42);
+  assert(invoke_value(counter) == 42);
+
+  try {
+    invoke_add(counter, -1);
+
+    assert(false);
+  } catch (const java_exception_t &err) {
+    assert(err.class_name() == "java.lang.IndexOutOfBoundsException");
+  }
+
+  assert(invoke_value(counter) == 42);
+
+  auto other = counter_class();
+
+  peer::emplace(env, other);
+
+  invoke_increment(other);
+
+  assert(invoke_merge(counter, other) == 43);
+
+  peer::close(env, other);
+
+  try {
+    invoke_merge(counter, other);
+
+    assert(false);
+  } catch (const java_exception_t &err) {
+    assert(err.class_name() == "java.lang.IllegalStateException");
+  }
+
+  assert(invoke_value(counter) == 43);
+
+  peer::close(env, counter);
+
+  try {
+    invoke_increment(counter);
+
+    assert(false);
+  } catch (const java_exception_t &err) {
+    assert(err.class_name() == "java.lang.IllegalStateException");
+  }
+
+  try {
+    invoke_value(counter);
+
+    assert(false);
+  } catch (const java_exception_t &err) {
+    assert(err.class_name() == "java.lang.IllegalStateException");
+    assert(err.message() == "Native peer is closed");
+  }
+}
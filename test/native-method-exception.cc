@@ -0,0 +1,25 @@
+#include <assert.h>
+#include <jnitl.h>
+
+auto
+fail(java_env_t env, java_object_t<"java/lang/String"> receiver, std::string argument) {
+  throw std::invalid_argument(argument);
+
+  return argument.size();
+}
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto trampoline = java_callback_t<fail>::create();
+
+  trampoline(env, nullptr, java_string_t(env, "oops"));
+
+  assert(static_cast<JNIEnv *>(env)->ExceptionCheck());
+
+  auto err = java_exception_t::occurred(env);
+
+  assert(err.class_name() == "java.lang.IllegalArgumentException");
+  assert(err.message() == "oops");
+}
@@ -6,11 +6,58 @@ hello(java_env_t env, java_object_t<"java/lang/String"> receiver, std::string ar
   return argument.size();
 }
 
+int
+length(java_env_t env, java_object_t<"to/holepunch/jnitl/test/Natives"> receiver, std::string suffix) {
+  auto name = java_class_t<"to/holepunch/jnitl/test/Natives">(env).get_method<std::string()>("name");
+
+  return static_cast<int>((name(receiver) + suffix).size());
+}
+
+int
+answer(java_env_t env, java_class_t<"to/holepunch/jnitl/test/Natives"> receiver) {
+  return 42;
+}
+
+std::string
+greet(java_env_t env, java_class_t<"to/holepunch/jnitl/test/Natives"> receiver, std::string name) {
+  return "hello " + name;
+}
+
 int
 main() {
-  auto [vm, env] = java_vm_t::create();
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
 
   auto string_class = java_class_t<"java/lang/String">(env);
 
-  string_class.register_natives(java_native_method_t<hello>("hello"));
+  bool thrown = false;
+
+  try {
+    string_class.register_natives<java_native_method_t<hello, "hello">>();
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  auto natives_class = java_class_t<"to/holepunch/jnitl/test/Natives">(env);
+
+  natives_class.register_natives<
+    java_native_method_t<length, "length">,
+    java_native_method_t<answer, "answer">>();
+
+  natives_class.register_natives(java_native_method_t<greet, "greet">());
+
+  auto natives = natives_class(std::string("native"));
+
+  auto invoke_length = natives_class.get_method<int(std::string)>("length");
+
+  assert(invoke_length(natives, "-method") == 13);
+
+  auto invoke_answer = natives_class.get_static_method<int()>("answer");
+
+  assert(invoke_answer() == 42);
+
+  auto invoke_greet = natives_class.get_static_method<std::string(std::string)>("greet");
+
+  assert(invoke_greet("world") == "hello world");
 }
@@ -0,0 +1,37 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+length(java_env_t env, java_object_t<"to/holepunch/jnitl/test/Natives"> receiver, std::string suffix) {
+  return static_cast<int>(suffix.size());
+}
+
+int
+answer(java_env_t env, java_class_t<"to/holepunch/jnitl/test/Natives"> receiver) {
+  return 42;
+}
+
+JNITL_NATIVES("to/holepunch/jnitl/test/Natives", java_native_method_t<length, "length">)
+
+JNITL_NATIVES("to/holepunch/jnitl/test/Natives", java_native_method_t<answer, "answer">)
+
+JNITL_ONLOAD()
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  assert(JNI_OnLoad(vm, nullptr) == JNI_VERSION_1_6);
+
+  auto natives_class = java_class_t<"to/holepunch/jnitl/test/Natives">(env);
+
+  auto natives = natives_class(std::string("registry"));
+
+  auto invoke_length = natives_class.get_method<int(std::string)>("length");
+
+  assert(invoke_length(natives, "suffix") == 6);
+
+  auto invoke_answer = natives_class.get_static_method<int()>("answer");
+
+  assert(invoke_answer() == 42);
+}
@@ -0,0 +1,17 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto object_class = java_class_t<"java/lang/Object">(env);
+
+  auto to_string = object_class.get_nonvirtual_method<std::string()>("toString");
+
+  auto string = java_string_t(env, "hello");
+
+  auto result = to_string(java_object_t<"java/lang/Object">(env, string));
+
+  assert(result.starts_with("java.lang.String@"));
+}
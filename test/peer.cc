@@ -0,0 +1,159 @@
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <jnitl.h>
+#include <thread>
+
+static std::atomic<int> destroyed = 0;
+
+static std::atomic<bool> entered = false;
+
+static std::atomic<bool> closing = false;
+
+struct counter_t {
+  using java_peer = java_peer_t<"to/holepunch/jnitl/test/Counter", counter_t>;
+
+  long value = 0;
+
+  counter_t() = default;
+
+  counter_t(long value) : value(value) {}
+
+  ~counter_t() {
+    destroyed++;
+  }
+};
+
+void
+increment(java_env_t env, counter_t &counter) noexcept {
+  counter.value++;
+}
+
+long
+add(java_env_t env, counter_t &counter, long amount) {
+  if (amount == 0) {
+    auto before = destroyed.load();
+
+    entered = true;
+
+    while (!closing) std::this_thread::yield();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    assert(destroyed == before);
+  }
+
+  return counter.value += amount;
+}
+
+long
+value(java_env_t env, const counter_t &counter) noexcept {
+  return counter.value;
+}
+
+long
+merge(java_env_t env, counter_t &counter, const counter_t &other) noexcept {
+  return counter.value += other.value;
+}
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  using peer = counter_t::java_peer;
+
+  auto counter_class = java_class_t<"to/holepunch/jnitl/test/Counter">(env);
+
+  counter_class.register_natives<
+    java_native_method_t<increment, "increment">,
+    java_native_method_t<add, "add">,
+    java_native_method_t<value, "value">,
+    java_native_method_t<merge, "merge">>();
+
+  auto invoke_increment = counter_class.get_method<void(), java_checked_t>("increment");
+  auto invoke_add = counter_class.get_method<long(long), java_checked_t>("add");
+  auto invoke_value = counter_class.get_method<long(), java_checked_t>("value");
+  auto invoke_merge = counter_class.get_method<long(java_object_t<"to/holepunch/jnitl/test/Counter">), java_checked_t>("merge");
+
+  auto counter = counter_class();
+
+  assert(peer::try_get(env, counter) == nullptr);
+
+  peer::emplace(env, counter, 40);
+
+  invoke_increment(counter);
+  invoke_increment(counter);
+
+  assert(invoke_value(counter) == 42);
+  assert(peer::get(env, counter).value == 42);
+
+  auto attached = counter_class();
+
+  peer::attach(env, attached, new counter_t());
+
+  assert(invoke_add(attached, 5) == 5);
+  assert(invoke_value(attached) == 5);
+
+  assert(invoke_merge(attached, counter) == 47);
+
+  peer::close(env, counter);
+
+  assert(destroyed == 1);
+  assert(peer::try_get(env, counter) == nullptr);
+
+  peer::close(env, counter);
+
+  assert(destroyed == 1);
+
+  for (auto call : {0, 1, 2, 3}) {
+    try {
+      if (call == 0) invoke_increment(counter);
+      else if (call == 1) invoke_add(counter, 1);
+      else if (call == 2) invoke_value(counter);
+      else invoke_merge(attached, counter);
+
+      assert(false);
+    } catch (const java_exception_t &err) {
+      assert(err.class_name() == "java.lang.IllegalStateException");
+      assert(err.message() == "Native peer is closed");
+    }
+  }
+
+  static_cast<JNIEnv *>(env)->DeleteLocalRef(attached);
+
+  auto gc = java_class_t<"java/lang/System">(env).get_static_method<void()>("gc");
+
+  for (int i = 0; i < 500 && destroyed != 2; i++) {
+    gc();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  assert(destroyed == 2);
+
+  auto busy = counter_class();
+
+  peer::emplace(env, busy, 7);
+
+  auto shared = java_shared_ref_t<java_object_t<"to/holepunch/jnitl/test/Counter">>(busy);
+
+  long result = 0;
+
+  std::thread thread([&] {
+    auto env = vm.attach_current_thread();
+
+    result = invoke_add(shared.get(env), 0);
+  });
+
+  while (!entered) std::this_thread::yield();
+
+  closing = true;
+
+  peer::close(env, busy);
+
+  assert(destroyed == 3);
+
+  thread.join();
+
+  assert(result == 7);
+}
@@ -0,0 +1,77 @@
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <jnitl.h>
+#include <optional>
+#include <thread>
+
+static std::atomic<int> destroyed = 0;
+
+struct counter_t {
+  using java_peer = java_peer_t<"to/holepunch/jnitl/test/Counter", counter_t>;
+
+  ~counter_t() {
+    destroyed++;
+  }
+};
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  using peer = counter_t::java_peer;
+
+  auto counter_class = java_class_t<"to/holepunch/jnitl/test/Counter">(env);
+
+  auto gc = java_class_t<"java/lang/System">(env).get_static_method<void()>("gc");
+
+  {
+    java_reclamation_queue_t queue(env);
+
+    std::optional<java_epoch_guard_t> guard = java_epoch_t::enter();
+
+    auto closed = counter_class();
+
+    peer::emplace(env, closed);
+
+    peer::close(env, closed);
+
+    assert(destroyed == 0);
+
+    for (int i = 0; i < 64; i++) {
+      auto counter = counter_class();
+
+      peer::emplace(env, counter);
+
+      static_cast<JNIEnv *>(env)->DeleteLocalRef(counter);
+    }
+
+    for (int i = 0; i < 20; i++) {
+      gc();
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    assert(destroyed == 0);
+
+    guard.reset();
+
+    for (int i = 0; i < 500 && destroyed != 65; i++) {
+      gc();
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    assert(destroyed == 65);
+
+    auto pending = counter_class();
+
+    peer::emplace(env, pending);
+
+    assert(peer::apply(env, pending, [](counter_t &counter) { return &counter; }) == peer::try_get(env, pending));
+
+    peer::close(env, pending);
+  }
+
+  assert(destroyed == 66);
+}
@@ -0,0 +1,68 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  auto ring_buffer_class = java_class_t<"to/holepunch/jnitl/RingBuffer">(env);
+
+  auto allocate = ring_buffer_class.get_static_method<java_object_t<"to/holepunch/jnitl/RingBuffer">(int)>("allocate");
+
+  auto get_buffer = ring_buffer_class.get_method<java_object_t<"java/nio/ByteBuffer">()>("buffer");
+
+  auto buffer = java_byte_buffer_t(env, get_buffer(allocate(1024)));
+
+  assert(buffer.size() == java_ring_buffer_t::length(1024));
+
+  auto ring_buffer = java_ring_buffer_t(buffer);
+
+  std::string messages[] = {"hello", "world", "!"};
+
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 3; j++) {
+      assert(ring_buffer.write(j, messages[j].data(), messages[j].size()));
+    }
+
+    int j = 0;
+
+    auto read = ring_buffer.read([&](int32_t type, std::span<const uint8_t> data) {
+      assert(type == j);
+      assert(std::string(data.begin(), data.end()) == messages[j]);
+
+      j++;
+    });
+
+    assert(read == 3);
+  }
+
+  size_t written = 0;
+
+  while (ring_buffer.write(0, messages[0].data(), messages[0].size())) written++;
+
+  assert(ring_buffer.read([](int32_t, std::span<const uint8_t>) {}) == written);
+
+  auto consumer_class = java_class_t<"to/holepunch/jnitl/test/RingBufferConsumer">(env);
+
+  auto drain = consumer_class.get_static_method<java_list_t<std::string>(java_object_t<"to/holepunch/jnitl/RingBuffer">)>("drain");
+
+  auto ring = allocate(1024);
+
+  auto shared = java_ring_buffer_t(java_byte_buffer_t(env, get_buffer(ring)));
+
+  for (int i = 0; i < 100; i++) {
+    for (int j = 0; j < 3; j++) {
+      assert(shared.write(j, messages[j].data(), messages[j].size()));
+    }
+
+    auto records = drain(ring);
+
+    assert(records.size() == 3);
+
+    for (int j = 0; j < 3; j++) {
+      assert(records[j] == std::to_string(j) + ":" + messages[j]);
+    }
+  }
+
+  assert(drain(ring).empty());
+}
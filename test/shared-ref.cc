@@ -0,0 +1,70 @@
+#include <assert.h>
+#include <chrono>
+#include <jnitl.h>
+#include <thread>
+#include <vector>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto raw = static_cast<JNIEnv *>(env);
+
+  auto gc = java_class_t<"java/lang/System">(env).get_static_method<void()>("gc");
+
+  auto object = java_class_t<"java/lang/Object">(env)();
+
+  auto weak = raw->NewWeakGlobalRef(object);
+
+  auto shared = java_shared_ref_t<java_object_t<"java/lang/Object">>(object);
+
+  raw->DeleteLocalRef(object);
+
+  assert(shared.use_count() == 1);
+
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&vm, &weak, copy = shared] {
+      auto env = vm.attach_current_thread();
+
+      for (int j = 0; j < 1000; j++) {
+        auto local = copy;
+
+        assert(local.use_count() >= 2);
+
+        assert(static_cast<JNIEnv *>(env)->IsSameObject(local.get(env), weak));
+      }
+    });
+  }
+
+  for (auto &thread : threads) thread.join();
+
+  assert(shared.use_count() == 1);
+
+  auto last = shared;
+
+  assert(shared.use_count() == 2);
+
+  shared = {};
+
+  assert(last.use_count() == 1);
+
+  gc();
+
+  assert(!raw->IsSameObject(weak, nullptr));
+
+  std::thread([last = std::move(last)]() mutable {
+    last = {};
+  }).join();
+
+  for (int i = 0; i < 100 && !raw->IsSameObject(weak, nullptr); i++) {
+    gc();
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  assert(raw->IsSameObject(weak, nullptr));
+
+  raw->DeleteWeakGlobalRef(weak);
+}
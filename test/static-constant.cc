@@ -0,0 +1,77 @@
+#include <assert.h>
+#include <jnitl.h>
+#include <thread>
+#include <vector>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create("-Djava.class.path=" JNITL_CLASS_PATH);
+
+  auto integer_class = java_class_t<"java/lang/Integer">(env);
+
+  auto max_value = integer_class.get_constant<int>("MAX_VALUE");
+
+  assert(max_value.get() == 2147483647);
+
+  int value = max_value;
+
+  assert(value == 2147483647);
+
+  auto boolean_class = java_class_t<"java/lang/Boolean">(env);
+
+  auto true_value = boolean_class.get_constant<java_object_t<"java/lang/Boolean">>("TRUE");
+
+  auto true_field = boolean_class.get_static_field<java_object_t<"java/lang/Boolean">>("TRUE");
+
+  assert(static_cast<JNIEnv *>(env)->IsSameObject(true_value, true_field.get(env)));
+
+  auto boolean_value = boolean_class.get_method<bool()>("booleanValue");
+
+  assert(boolean_value(true_value.get(env)));
+
+  auto copy = true_value;
+
+  std::thread thread([&vm, &boolean_value, copy] {
+    auto env = vm.attach_current_thread();
+
+    assert(boolean_value(copy.get(env)));
+  });
+
+  thread.join();
+
+  auto constants_class = java_class_t<"to/holepunch/jnitl/test/Constants">(env);
+
+  auto answer_field = constants_class.get_static_field<int>("answer");
+
+  auto answer = constants_class.get_constant<int>("answer");
+
+  answer_field.set(42);
+
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&vm, answer] {
+      auto env = vm.attach_current_thread();
+
+      assert(answer.get() == 42);
+    });
+  }
+
+  for (auto &thread : threads) thread.join();
+
+  answer_field.set(7);
+
+  assert(answer.get() == 42);
+
+  auto flag_field = constants_class.get_static_field<java_object_t<"java/lang/Boolean">>("flag");
+
+  auto flag = constants_class.get_constant<java_object_t<"java/lang/Boolean">>("flag");
+
+  flag_field.set(true_field.get(env));
+
+  assert(boolean_value(flag.get(env)));
+
+  flag_field.set(boolean_class.get_static_field<java_object_t<"java/lang/Boolean">>("FALSE").get(env));
+
+  assert(boolean_value(flag.get(env)));
+}
@@ -0,0 +1,37 @@
+#include <assert.h>
+#include <jnitl.h>
+
+struct point_t {
+  int x;
+  int y;
+};
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto point_class = java_class_t<"java/awt/Point">(env);
+
+  auto point = java_struct_t<"java/awt/Point", point_t, java_member_t<&point_t::x, "x">, java_member_t<&point_t::y, "y">>(point_class);
+
+  auto object = point_class(1, 2);
+
+  auto result = point.read(object);
+
+  assert(result.x == 1);
+  assert(result.y == 2);
+
+  point.write(object, point_t{3, 4});
+
+  result = point.read(object);
+
+  assert(result.x == 3);
+  assert(result.y == 4);
+
+  auto array = java_array_t<java_object_t<"java/awt/Point">>(env, 2, point_class, object);
+
+  auto results = point.read(array);
+
+  assert(results.size() == 2);
+  assert(results[1].y == 4);
+}
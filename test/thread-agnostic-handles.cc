@@ -0,0 +1,28 @@
+#include <assert.h>
+#include <jnitl.h>
+#include <thread>
+
+int
+main() {
+  auto [vm, env] = java_vm_t::create();
+
+  auto integer_class = java_class_t<"java/lang/Integer">(env);
+
+  auto parse_int = integer_class.get_static_method<int(std::string)>("parseInt");
+
+  auto max_value = integer_class.get_static_field<int>("MAX_VALUE");
+
+  auto length = java_class_t<"java/lang/String">(env).get_method<int()>("length");
+
+  std::thread thread([&] {
+    auto env = vm.attach_current_thread();
+
+    assert(parse_int("42") == 42);
+
+    assert(max_value.get() == 2147483647);
+
+    assert(length(java_string_t(env, "hello")) == 5);
+  });
+
+  thread.join();
+}
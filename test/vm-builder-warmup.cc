@@ -0,0 +1,26 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto builder = java_vm_builder_t()
+                   .class_path(JNITL_CLASS_PATH)
+                   .warmup_class("to/holepunch/jnitl/test/Constants");
+
+  auto [vm, env] = builder.create();
+
+  auto &stats = builder.stats();
+
+#if JNITL_DYNAMIC_JVM
+  assert(stats.load.count() > 0);
+#endif
+
+  assert(stats.create.count() > 0);
+  assert(stats.first_find_class.count() > 0);
+  assert(stats.first_class_load >= stats.first_find_class);
+  assert(!stats.warmup_failed);
+
+  auto constants_class = java_class_t<"to/holepunch/jnitl/test/Constants">(env);
+
+  assert(constants_class.get_static_field<int>("answer").get() == 1);
+}
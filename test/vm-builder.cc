@@ -0,0 +1,38 @@
+#include <assert.h>
+#include <jnitl.h>
+
+int
+main() {
+  auto builder = java_vm_builder_t();
+
+  bool thrown = false;
+
+  try {
+    builder.option("bogus");
+  } catch (const std::invalid_argument &) {
+    thrown = true;
+  }
+
+  assert(thrown);
+
+  builder
+    .class_path(JNITL_CLASS_PATH)
+    .option("-Xss1m")
+    .version(JNI_VERSION_1_8)
+    .warmup_class("to/holepunch/jnitl/Missing");
+
+  auto [vm, env] = builder.create();
+
+  auto &stats = builder.stats();
+
+  assert(stats.create.count() > 0);
+  assert(stats.first_find_class.count() > 0);
+  assert(stats.first_class_load.count() == 0);
+  assert(stats.warmup_failed);
+
+  assert(java_vm_t::get_created().has_value());
+
+  assert(!static_cast<JNIEnv *>(env)->ExceptionCheck());
+
+  auto native_peer = java_class_t<"to/holepunch/jnitl/NativePeer">(env);
+}